@@ -41,6 +41,20 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
+/* 1: 无节拍空闲，主循环无事可做时把 TIM17 节拍周期拉长到下一个截止时刻 (单次最长约 655ms) 后 WFI 休眠，
+      按键边沿由 EXTI 唤醒; 0: 始终 1ms 节拍轮询，按键空闲时扫描任务同样打开 EXTI 并停止扫描，边沿唤醒 */
+#define TICKLESS_IDLE   1
+
+/* 1: TIM17 节拍中断直接清更新标志后进入 App_TickHandler，跳过 HAL_TIM_IRQHandler 的逐个标志检查;
+      0: 经 HAL_TIM_PeriodElapsedCallback 分发 */
+#define TICK_FAST_PATH  1
+
+/* 1: 统一时基，TIM17 中断同时推进 HAL tick 和驱动周期任务，SysTick 只作为自由运行的周期计数器 (不产生中断);
+      0: SysTick 中断推进 HAL tick，TIM17 中断驱动周期任务 */
+#define UNIFIED_TIMEBASE  1
+
+/* 1: 统计节拍中断入口到第一个周期任务开始执行的 CPU 周期数 (见 main.c 中的 tick_bench) */
+#define TICK_BENCH      0
 
 /* USER CODE END EC */
 
@@ -53,6 +67,12 @@ extern "C" {
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
+// 1ms 节拍处理，由 TIM17 中断调用
+void App_TickHandler(void);
+
+#if TICK_BENCH
+extern volatile uint32_t tick_bench_entry; // 节拍中断入口的 SysTick->VAL
+#endif
 
 /* USER CODE END EFP */
 
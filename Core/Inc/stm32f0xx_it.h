@@ -48,11 +48,14 @@
 /* Exported functions prototypes ---------------------------------------------*/
 void NMI_Handler(void);
 void HardFault_Handler(void);
-void SVC_Handler(void);
-void PendSV_Handler(void);
 void SysTick_Handler(void);
+void EXTI2_3_IRQHandler(void);
+void EXTI4_15_IRQHandler(void);
 void TIM17_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Channel4_5_IRQHandler(void);
+void DMA1_Channel2_3_IRQHandler(void);
+void TIM14_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -25,6 +25,15 @@
 /* USER CODE BEGIN Includes */
 #include "button.h"
 #include "rgb_led.h"
+#include "led_compositor.h"
+#include "scheduler.h"
+#include "soft_timer.h"
+#include "kernel.h"
+#include "profiler.h"
+#include "mempool.h"
+#include "trace.h"
+#include "uart_tx.h"
+#include "tickless.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -34,9 +43,12 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-Button_t myButton;
-Button_t myButton2;
+Button_t myButtons[2];      // 按键运行状态，与 myButtonCfg 一一对应
+ButtonPort_t myButtonPort;
 RGB_LED_t my_led;
+LED_Compositor_t my_led_layers; // 背景/状态/告警 图层合成到 my_led
+Sched_t mySchedInput;   // 输入任务: 软件定时器、按键扫描
+Sched_t mySchedRender;  // 渲染任务: LED 合成
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -59,7 +71,81 @@ void SystemClock_Config(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-uint32_t on_mo_time = 20 * 1000 ; // 上次按键扫描时间
+#if TICKLESS_IDLE
+// 无节拍空闲: 算出所有任务的下一个截止时刻，休眠到该时刻或任一中断 (见 tickless.h)
+static void Idle_Sleep(void)
+{
+    uint32_t ms;
+
+    // 关中断后再计算，确保计算到 WFI 之间发生的中断都能唤醒
+    __disable_irq();
+    ms = Button_HasEvents() ? 0 : Sched_NextDeadline(&mySchedInput);
+    if (ms) {
+        uint32_t render = Sched_NextDeadline(&mySchedRender);
+        if (render < ms) {
+            ms = render;
+        }
+    }
+    if (ms <= 1) {
+        // 下一个节拍就有任务，只休眠到下一个中断
+        __WFI();
+    } else if (Button_PortSleep(&myButtonPort)) {
+        // 只在真正休眠前打开按键 EXTI，由边沿唤醒；打开前后电平变化时不休眠，下一次扫描开始消抖
+        Tickless_Sleep(ms);
+    }
+    __enable_irq();
+}
+#endif
+
+#if UNIFIED_TIMEBASE
+static uint8_t s_timebase_unified; // TIM17 已接管 HAL tick
+
+// 由 TIM17 接管 HAL tick: 关闭 SysTick 中断，SysTick 改为 24 位自由运行计数器，只用于耗时统计
+// 上电到此之前 (时钟配置等) 仍由 SysTick 中断计时，HAL 的超时判断不受影响
+static void Timebase_Unify(void)
+{
+    __disable_irq();
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk; // 先停止，同时关闭中断
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;         // 丢弃可能已挂起的 SysTick 中断
+    s_timebase_unified = 1;
+    __enable_irq();
+}
+#endif
+
+#if PROFILER_ENABLE
+#define PROF_DUMP_PERIOD_MS  10000 // 耗时统计输出周期
+
+static volatile uint8_t prof_dump_due;
+
+// 定时器回调在输入任务中执行，只置标志，由主循环输出
+static void Prof_DumpTimer(void *arg)
+{
+    (void)arg;
+    prof_dump_due = 1;
+}
+#endif
+
+#if TRACE_ENABLE
+#define TRACE_DUMP_PERIOD_MS  10000 // 事件追踪输出周期
+
+static volatile uint8_t trace_dump_due;
+
+static void Trace_DumpTimer(void *arg)
+{
+    (void)arg;
+    trace_dump_due = 1;
+}
+#endif
+
+// MO 引脚 (PA8) 控制 monitor，电平变化同时记入事件追踪
+static void Monitor_Set(GPIO_PinState state)
+{
+    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, state);
+    TRACE(TRACE_MONITOR, state);
+}
 
 uint8_t mo_long_state = 0; // 按键状态
 
@@ -67,18 +153,16 @@ void Button_LongCallback()
 {
 
     mo_long_state = 1;
-    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_SET); // 打开monitor
-    RGB_LED_StartWhiteBreath(&my_led, 2000);// 启动白色呼吸灯效果
+    Monitor_Set(GPIO_PIN_SET); // 打开monitor
+    RGB_LED_StartWhiteBreath(LED_Compositor_Layer(&my_led_layers, LED_LAYER_BACKGROUND), 2000);// 启动白色呼吸灯效果
+    LED_Compositor_Show(&my_led_layers, LED_LAYER_BACKGROUND, LED_ALPHA_OPAQUE, 0);
+    LED_Compositor_Hide(&my_led_layers, LED_LAYER_STATUS);
 }
 
-void Button_ClickCallback(uint8_t count)
+void Button_ClickCallback(void)
 {
-    // 按键点击回调函数
+    // 按键点击回调函数，每次短按调用一次 (驱动不统计连击次数)
     // 这里可以添加按键点击后的处理逻辑
-    if (count == 1) 
-    {
-
-    } 
 }
 void Button_InactiveCallback()
 {
@@ -87,8 +171,9 @@ void Button_InactiveCallback()
     {
          // 无活动回调函数
         // 这里可以添加无活动后的处理逻辑
-        HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_RESET); // 关闭monitor 
-        RGB_LED_StartFlash(&my_led, 255, 0, 0, 200, 200);
+        Monitor_Set(GPIO_PIN_RESET); // 关闭monitor 
+        RGB_LED_StartFlash(LED_Compositor_Layer(&my_led_layers, LED_LAYER_STATUS), 255, 0, 0, 200, 200);
+        LED_Compositor_Show(&my_led_layers, LED_LAYER_STATUS, LED_ALPHA_OPAQUE, 0);
         mo_long_state = 0; // 重置状态
     }
     
@@ -104,17 +189,163 @@ void Button_LongPressReleaseCallback()
 void Button2_longpress_handler() 
 {
     // 按下时执行的代码...
-    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_SET); // 打开monitor
-    RGB_LED_StartFlash(&my_led, 0, 0, 255, 400, 400);
+    Monitor_Set(GPIO_PIN_SET); // 打开monitor
+    // 按住期间蓝色闪烁覆盖在最上层，松开后隐藏
+    RGB_LED_StartFlash(LED_Compositor_Layer(&my_led_layers, LED_LAYER_ALERT), 0, 0, 255, 400, 400);
+    LED_Compositor_Show(&my_led_layers, LED_LAYER_ALERT, LED_ALPHA_OPAQUE, 0);
 }
 
 void Button2_release_handler() 
 {
     // 抬起时执行的代码...
-    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8, GPIO_PIN_RESET); // 关闭monitor 
-    RGB_LED_StartFlash(&my_led, 255, 0, 0, 200, 200);
+    Monitor_Set(GPIO_PIN_RESET); // 关闭monitor 
+    LED_Compositor_Hide(&my_led_layers, LED_LAYER_ALERT);
+    RGB_LED_StartFlash(LED_Compositor_Layer(&my_led_layers, LED_LAYER_STATUS), 255, 0, 0, 200, 200);
+    LED_Compositor_Show(&my_led_layers, LED_LAYER_STATUS, LED_ALPHA_OPAQUE, 0);
+}
+
+// 按键描述符表 (const，位于 Flash)，同一端口按引脚号升序排列
+static const Button_Config_t myButtonCfg[] = {
+    {   // PA3: 长按打开monitor，松开后无活动 5s 关闭
+        .port = GPIOA, .pin = GPIO_PIN_3,
+        .long_press_time = BUTTON_LONG_PRESS_TIME,
+        .debounce_time = BUTTON_DEBOUNCE_TIME,
+        .inactive_time = 5000,
+        .on_short_press = Button_ClickCallback,
+        .on_long_press = Button_LongCallback,
+        .on_long_press_release = Button_LongPressReleaseCallback,
+        .on_inactive = Button_InactiveCallback,
+    },
+    {   // PA4: 按下打开monitor，抬起关闭
+        .port = GPIOA, .pin = GPIO_PIN_4,
+        .long_press_time = BUTTON_LONG_PRESS_TIME,
+        .debounce_time = BUTTON_DEBOUNCE_TIME,
+        .on_press = Button2_longpress_handler,
+        .on_release = Button2_release_handler,
+    },
+};
+
+static void Task_ButtonScan(void *arg)
+{
+    ButtonPort_t *bp = (ButtonPort_t *)arg;
+
+    // EXTI 已打开: 端口空闲，停止扫描，等待边沿唤醒 (长按/无活动计时由软件定时器完成)
+    if (Button_PortAsleep(bp)) {
+        return;
+    }
+    Button_ScanPort(bp);
+#if !TICKLESS_IDLE
+    // 不休眠时在扫描后切换到边沿唤醒；无节拍空闲时由 Idle_Sleep 在休眠前打开
+    Button_PortSleep(bp);
+#endif
+}
+
+// 消抖中需要按周期扫描；空闲时只在长按/无活动计时到期时唤醒。只做查询，EXTI 在 Idle_Sleep 中打开
+static uint32_t Task_ButtonIdle(void *arg)
+{
+    const ButtonPort_t *bp = (const ButtonPort_t *)arg;
+    return Button_PortIdle(bp) ? Button_PortNextDeadline(bp) : 0;
+}
+
+static void Task_SoftTimer(void *arg)
+{
+    (void)arg;
+    SoftTimer_Tick();
 }
 
+static uint32_t Task_SoftTimerIdle(void *arg)
+{
+    (void)arg;
+    return SoftTimer_NextDeadline();
+}
+
+static void Task_LedUpdate(void *arg)
+{
+    PROF_ENTER(PROF_COMPOSITOR);
+    LED_Compositor_Update((LED_Compositor_t *)arg);
+    PROF_EXIT(PROF_COMPOSITOR);
+}
+
+static uint32_t Task_LedIdle(void *arg)
+{
+    return LED_Compositor_NextDeadline((const LED_Compositor_t *)arg);
+}
+
+// 周期任务表 (const，位于 Flash)，由 TIM17 1ms 节拍驱动，偏移错开各任务的执行时刻
+// 输入类任务短小且对延迟敏感，在高优先级内核任务中执行
+static const Sched_Task_t myInputTasks[] = {
+    // 软件定时器: 每 tick 推进时间轮，只有到期的定时器才有开销
+    { Task_SoftTimer, 0, 1, 0, Task_SoftTimerIdle },
+    // 按键: 5ms 扫描，垂直计数器4次采样即 20ms 消抖
+    { Task_ButtonScan, &myButtonPort, 5, 0, Task_ButtonIdle },
+};
+static Sched_TaskStats_t myInputStats[sizeof(myInputTasks) / sizeof(myInputTasks[0])];
+
+// 渲染类任务耗时较长，在低优先级内核任务中执行，可被输入任务抢占
+static const Sched_Task_t myRenderTasks[] = {
+    // LED: 按帧率合成输出
+    { Task_LedUpdate, &my_led_layers, RGB_LED_DEFAULT_FRAME_MS, 2, Task_LedIdle },
+};
+static Sched_TaskStats_t myRenderStats[sizeof(myRenderTasks) / sizeof(myRenderTasks[0])];
+
+// 内核任务优先级 (任务表下标加1)，数值越大越优先
+enum {
+    PRIO_RENDER = 1,
+    PRIO_INPUT  = 2,
+};
+
+// 内核事件信号
+enum {
+    SIG_TICK = 1,  // 1ms 节拍
+};
+
+#if TICK_BENCH
+// 节拍中断入口到输入任务开始执行的 CPU 周期数，对比 TICK_FAST_PATH 0/1 两种分发路径
+typedef struct {
+    uint32_t last;
+    uint32_t worst;
+    uint32_t samples;
+} TickBench_t;
+
+volatile uint32_t tick_bench_entry;
+TickBench_t tick_bench;
+
+static void TickBench_Sample(void)
+{
+    uint32_t now = SysTick->VAL;
+    uint32_t entry = tick_bench_entry;
+    // SysTick 递减计数，差值按重装值回绕
+    uint32_t cycles = (entry >= now) ? (entry - now) : (entry + SysTick->LOAD + 1 - now);
+
+    tick_bench.last = cycles;
+    if (cycles > tick_bench.worst) {
+        tick_bench.worst = cycles;
+    }
+    tick_bench.samples++;
+}
+#endif
+
+// 节拍事件: 队列满说明任务还没跑完上一个节拍，丢弃即可，Sched_Tick 按时间戳补齐
+static void KTask_Tick(void *arg, Kernel_Event_t evt)
+{
+    (void)evt;
+#if TICK_BENCH
+    if (arg == &mySchedInput) {
+        TickBench_Sample();
+    }
+#endif
+    Sched_Tick((Sched_t *)arg);
+}
+
+static Kernel_Event_t myRenderQueue[2];
+static Kernel_Event_t myInputQueue[2];
+
+// 内核任务表 (const，位于 Flash)，按优先级从低到高排列
+static const Kernel_Task_t myKernelTasks[] = {
+    { KTask_Tick, &mySchedRender, myRenderQueue, sizeof(myRenderQueue) / sizeof(myRenderQueue[0]) },
+    { KTask_Tick, &mySchedInput,  myInputQueue,  sizeof(myInputQueue) / sizeof(myInputQueue[0]) },
+};
+static Kernel_TaskState_t myKernelState[sizeof(myKernelTasks) / sizeof(myKernelTasks[0])];
 
 /* USER CODE END 0 */
 
@@ -150,35 +381,74 @@ int main(void)
   MX_TIM17_Init();
   MX_TIM1_Init();
   /* USER CODE BEGIN 2 */
-
-  Button_Init(&myButton, GPIOA, GPIO_PIN_3); // 初始化按键，连接到PC3
-
-  Button_SetShortPressCallback(&myButton, Button_ClickCallback);
-  Button_SetLongPressCallback(&myButton, Button_LongCallback); // 设置长按回调函数，如果不需要可以传NULL
-  Button_SetInactiveCallback(&myButton, Button_InactiveCallback, 5000); // 设置无活动回调函数，如果不需要可以传NULL和0
-  Button_SetLongPressReleaseCallback(&myButton, Button_LongPressReleaseCallback); // 设置长按抬起回调函数，如果不需要可以传NULL
-
-  Button_Init(&myButton2, GPIOA, GPIO_PIN_4); // 初始化按键，连接到PC3
-
-  Button_SetPressCallback(&myButton2, Button2_longpress_handler);
-  Button_SetReleaseCallback(&myButton2, Button2_release_handler);
+  Mem_Init(); // UART 发送缓冲区从内存池申请，须先于 UartTx_Init
+  UartTx_Init(); // USART1 DMA 发送，printf (内部分配由内存池提供) 和耗时统计/事件追踪的输出都经过它
+  Prof_Init(); // PROFILER_ENABLE 为0时为空
+  Trace_Init(); // TRACE_ENABLE 为0时为空
+
+  // PA3/PA4 共用一次 IDR 读取
+  SoftTimer_Init(); // 按键计时使用软件定时器，须先于 Button_PortInit
+#if PROFILER_ENABLE
+  SoftTimer_Start(SoftTimer_Create(Prof_DumpTimer, 0), PROF_DUMP_PERIOD_MS, PROF_DUMP_PERIOD_MS);
+#endif
+#if TRACE_ENABLE
+  SoftTimer_Start(SoftTimer_Create(Trace_DumpTimer, 0), TRACE_DUMP_PERIOD_MS, TRACE_DUMP_PERIOD_MS);
+#endif
+  Button_PortInit(&myButtonPort, myButtonCfg, myButtons, sizeof(myButtonCfg) / sizeof(myButtonCfg[0]));
+  Button_PortWake(&myButtonPort); // 上电先轮询扫描，空闲后再切换到 EXTI 唤醒
 
 
   RGB_LED_Init(&my_led, LED_CONNECTION_COMMON_ANODE, 
               &htim1, TIM_CHANNEL_2,
               &htim1, TIM_CHANNEL_3,
               &htim1, TIM_CHANNEL_4);
-
-  RGB_LED_StartWhiteBreath(&my_led, 2000);
+  // 呼吸/闪烁由 DMA 回放，不占用渲染任务。DMA 帧间隔不超过 my_led 的 10ms 帧间隔，64 帧缓冲区只放得下
+  // 周期不超过 640ms 的效果 (告警/状态层的闪烁)；2s 背景呼吸需要 200 帧 (1.2KB，4KB RAM 放不下)，
+  // 自动退回渲染任务按 10ms 计算。用 LED_PLAYBACK_DMA_HALF 可以放进 20ms 帧间隔，但没有 CIE 校正
+  RGB_LED_SetPlayback(&my_led, LED_PLAYBACK_DMA);
+
+  // 最上层的不透明呼吸/闪烁图层直接交给 my_led 的 DMA 回放 (满足上面的帧间隔时)
+  LED_Compositor_Init(&my_led_layers, &my_led);
+  RGB_LED_StartWhiteBreath(LED_Compositor_Layer(&my_led_layers, LED_LAYER_BACKGROUND), 2000);
+  LED_Compositor_Show(&my_led_layers, LED_LAYER_BACKGROUND, LED_ALPHA_OPAQUE, 0);
+
+  Sched_Init(&mySchedInput, myInputTasks, myInputStats, sizeof(myInputTasks) / sizeof(myInputTasks[0]));
+  Sched_Init(&mySchedRender, myRenderTasks, myRenderStats, sizeof(myRenderTasks) / sizeof(myRenderTasks[0]));
+#if UNIFIED_TIMEBASE
+  Timebase_Unify();
+#endif
+#if TICKLESS_IDLE
+  Tickless_Init(&htim17, UNIFIED_TIMEBASE); // 统一时基时 TIM17 节拍同时推进 HAL tick
+#endif
+  Kernel_Init(myKernelTasks, myKernelState, sizeof(myKernelTasks) / sizeof(myKernelTasks[0]));
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
+    // 按键回调在主循环中执行，不占用 TIM17 中断时间
+    Button_DispatchEvents();
+
+#if PROFILER_ENABLE
+    if (prof_dump_due) {
+        prof_dump_due = 0;
+        Prof_Dump(); // 写入 DMA 发送缓冲区，满时等待 DMA 腾出空间；在主循环中执行，不影响内核任务
+    }
+#endif
+
+#if TRACE_ENABLE
+    if (trace_dump_due) {
+        trace_dump_due = 0;
+        Trace_Dump();
+    }
+#endif
+
+#if TICKLESS_IDLE
+    // 休眠到下一个任务截止时刻或任一中断
+    Idle_Sleep();
+#endif
 
-    
-    
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -227,21 +497,32 @@ void SystemClock_Config(void)
 /* USER CODE BEGIN 4 */
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
-  if (GPIO_Pin == GPIO_PIN_3)
+  TRACE(TRACE_EXTI, GPIO_Pin);
+  if (GPIO_Pin & myButtonPort.pin_mask)
   {
-    // 执行中断响应逻辑，例如翻转LED
-    HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);
+    // 按键边沿唤醒: 屏蔽 EXTI，恢复周期扫描，由垂直计数器完成消抖
+    Button_PortWake(&myButtonPort);
   }
 }
 
+// 每 1ms 进一次，只投递节拍事件，周期任务在内核任务中执行 (见 myKernelTasks)
+void App_TickHandler(void)
+{
+#if UNIFIED_TIMEBASE
+    // 先推进 HAL tick，本节拍内所有任务读到的 HAL_GetTick 都是最新值
+    if (s_timebase_unified) {
+        HAL_IncTick();
+    }
+#endif
+    Kernel_Post(PRIO_INPUT, SIG_TICK, 0);
+    Kernel_Post(PRIO_RENDER, SIG_TICK, 0);
+}
+
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
     if (htim->Instance == TIM17)
     {
-        // 每 1ms 进一次，可用于执行按键扫描等任务
-        Button_Scan(&myButton);
-        Button_Scan(&myButton2);
-        RGB_LED_Update(&my_led);
+        App_TickHandler();
     }
 }
 
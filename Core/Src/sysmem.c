@@ -53,10 +53,8 @@ static uint8_t *__sbrk_heap_end = NULL;
 void *_sbrk(ptrdiff_t incr)
 {
   extern uint8_t _end; /* Symbol defined in the linker script */
-  extern uint8_t _estack; /* Symbol defined in the linker script */
-  extern uint32_t _Min_Stack_Size; /* Symbol defined in the linker script */
-  const uint32_t stack_limit = (uint32_t)&_estack - (uint32_t)&_Min_Stack_Size;
-  const uint8_t *max_heap = (uint8_t *)stack_limit;
+  extern uint8_t _eheap; /* 堆区上界 (链接脚本定义，栈在 RAM 顶部时即栈区下界) */
+  const uint8_t *max_heap = &_eheap;
   uint8_t *prev_heap_end;
 
   /* Initialize heap end at first call */
@@ -39,7 +39,13 @@ set(CMAKE_ASM_FLAGS "${CMAKE_C_FLAGS} -x assembler-with-cpp -MMD -MP")
 set(CMAKE_CXX_FLAGS "${CMAKE_C_FLAGS} -fno-rtti -fno-exceptions -fno-threadsafe-statics")
 
 set(CMAKE_C_LINK_FLAGS "${TARGET_FLAGS}")
-set(CMAKE_C_LINK_FLAGS "${CMAKE_C_LINK_FLAGS} -T \"${CMAKE_SOURCE_DIR}/stm32f030c6tx_flash.ld\"")
+# STACK_AT_BOTTOM=ON 时使用栈在 RAM 起始处的链接脚本，栈溢出直接触发 HardFault
+if(STACK_AT_BOTTOM)
+    set(LINKER_SCRIPT "${CMAKE_SOURCE_DIR}/stm32f030c6tx_flash_stack_bottom.ld")
+else()
+    set(LINKER_SCRIPT "${CMAKE_SOURCE_DIR}/stm32f030c6tx_flash.ld")
+endif()
+set(CMAKE_C_LINK_FLAGS "${CMAKE_C_LINK_FLAGS} -T \"${LINKER_SCRIPT}\"")
 set(CMAKE_C_LINK_FLAGS "${CMAKE_C_LINK_FLAGS} --specs=nano.specs")
 set(CMAKE_C_LINK_FLAGS "${CMAKE_C_LINK_FLAGS} -Wl,-Map=${CMAKE_PROJECT_NAME}.map -Wl,--gc-sections")
 set(CMAKE_C_LINK_FLAGS "${CMAKE_C_LINK_FLAGS} -Wl,--start-group -lc -lm -Wl,--end-group")
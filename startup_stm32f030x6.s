@@ -85,6 +85,33 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* 栈区 (当前 SP 以下) 和堆区填充哨兵值，memstat 据此统计高水位，
+   填充值须与 user/memstat.h 中的 MEMSTAT_PAINT 一致 */
+  ldr r3, =0xC5C5C5C5
+  ldr r2, =_sstack
+  mov r4, sp
+  b LoopPaintStack
+
+PaintStack:
+  str r3, [r2]
+  adds r2, r2, #4
+
+LoopPaintStack:
+  cmp r2, r4
+  bcc PaintStack
+
+  ldr r2, =_end
+  ldr r4, =_eheap
+  b LoopPaintHeap
+
+PaintHeap:
+  str r3, [r2]
+  adds r2, r2, #4
+
+LoopPaintHeap:
+  cmp r2, r4
+  bcc PaintHeap
+
 /* Call static constructors */
   bl __libc_init_array
 /* Call the application's entry point.*/
@@ -0,0 +1,42 @@
+/* === C/C++ Header代码文件: bench.h === */
+#ifndef __BENCH_H
+#define __BENCH_H
+
+// 主机基准的计时工具: 单调时钟，取多轮中最快的一轮，减少调度干扰
+// 结果是本机的 ns/次，只用于比较同一台机器上的不同实现，不代表 Cortex-M0 上的周期数
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_ROUNDS  7
+
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// 防止被测结果被优化掉
+static volatile uint32_t bench_sink;
+
+// BENCH(名称, 每轮操作数, 语句): 语句执行 ops 次为一轮，输出最快一轮的 ns/次
+#define BENCH(name, ops, stmt) do {                                          \
+    uint64_t best_ = UINT64_MAX;                                             \
+    int round_;                                                              \
+    for (round_ = 0; round_ < BENCH_ROUNDS; round_++) {                      \
+        uint64_t t0_ = bench_now_ns();                                       \
+        uint32_t i_;                                                         \
+        for (i_ = 0; i_ < (uint32_t)(ops); i_++) {                           \
+            stmt;                                                            \
+        }                                                                    \
+        t0_ = bench_now_ns() - t0_;                                          \
+        if (t0_ < best_) {                                                   \
+            best_ = t0_;                                                     \
+        }                                                                    \
+    }                                                                        \
+    printf("%-40s %10.2f ns/op\n", (name), (double)best_ / (double)(ops));   \
+} while (0)
+
+#endif
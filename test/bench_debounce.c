@@ -0,0 +1,88 @@
+/* === C代码文件: bench_debounce.c === */
+// 每个扫描节拍的按键处理耗时: 整端口垂直计数器 Button_ScanPort 与逐个按键调用 Button_Scan 对比，
+// 按键数 2/8/16。输入为真实节奏: 大部分时间松开，轮流有一个按键按下 100ms，按下/松开时各抖动 3 次
+#include "bench.h"
+#include "button.h"
+
+#define SAMPLES     4096   // 输入序列长度 (每个采样一个 1ms 扫描节拍)
+#define MAX_BUTTONS 16
+
+static uint16_t s_idr[SAMPLES];
+static Button_Config_t s_cfg[MAX_BUTTONS];
+static Button_t s_state[MAX_BUTTONS];
+static ButtonPort_t s_port;
+
+// active 为0时所有按键一直松开 (空闲)，否则每 256 个节拍轮到下一个按键按下
+static void _make_input(uint8_t count, uint8_t active)
+{
+    uint32_t t;
+
+    for (t = 0; t < SAMPLES; t++) {
+        uint16_t idr = 0xFFFFu;
+        uint32_t phase = t % 256u;
+        uint16_t pin = (uint16_t)(1u << ((t / 256u) % count));
+
+        if (active && phase < 100u) {
+            // 前 6 个节拍和最后 6 个节拍高低交替，模拟触点抖动
+            if ((phase >= 6u && phase < 94u) || (phase & 1u)) {
+                idr &= (uint16_t)~pin;
+            }
+        }
+        s_idr[t] = idr;
+    }
+}
+
+static void _setup(uint8_t count)
+{
+    uint8_t i;
+
+    SoftTimer_Init();
+    for (i = 0; i < count; i++) {
+        s_cfg[i].port = GPIOA;
+        s_cfg[i].pin = (uint16_t)(1u << i);
+        s_cfg[i].long_press_time = BUTTON_LONG_PRESS_TIME;
+        s_cfg[i].debounce_time = BUTTON_DEBOUNCE_TIME;
+        s_cfg[i].inactive_time = 0;
+        Button_Init(&s_state[i]);
+    }
+    GPIOA->IDR = 0xFFFFu;
+    uwTick = 0;
+    Button_PortInit(&s_port, s_cfg, s_state, count);
+}
+
+// 两种实现各自从同样的初始状态开始，时间在多轮之间单调递增。
+// 端口扫描的长按/无活动计时由软件定时器完成，每个节拍同时推进 SoftTimer_Tick，与逐个扫描内联计时的开销对等
+static void _bench(uint8_t count, uint8_t active)
+{
+    char name[64];
+    uint8_t b;
+
+    _make_input(count, active);
+
+    _setup(count);
+    snprintf(name, sizeof(name), "Button_ScanPort   %2u buttons, %s", count, active ? "presses" : "idle");
+    BENCH(name, 1000000,
+          uwTick++; GPIOA->IDR = s_idr[uwTick % SAMPLES];
+          Button_ScanPort(&s_port);
+          SoftTimer_Tick();
+          if ((uwTick & 63u) == 0) Button_DispatchEvents());
+
+    _setup(count);
+    snprintf(name, sizeof(name), "Button_Scan loop  %2u buttons, %s", count, active ? "presses" : "idle");
+    BENCH(name, 1000000,
+          uwTick++; GPIOA->IDR = s_idr[uwTick % SAMPLES];
+          for (b = 0; b < count; b++) Button_Scan(&s_cfg[b], &s_state[b]);
+          if ((uwTick & 63u) == 0) Button_DispatchEvents());
+}
+
+int main(void)
+{
+    static const uint8_t counts[] = { 2, 8, 16 };
+    uint8_t i;
+
+    for (i = 0; i < sizeof(counts); i++) {
+        _bench(counts[i], 0);
+        _bench(counts[i], 1);
+    }
+    return 0;
+}
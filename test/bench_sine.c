@@ -0,0 +1,59 @@
+/* === C代码文件: bench_sine.c === */
+// 呼吸亮度的计算耗时: 原来的 sinf 浮点公式与 Q15 四分之一正弦表 + 相位累加对比，
+// 以及一次完整的呼吸帧 (计算亮度并写3个 CCR)
+// 注意主机有硬件浮点，sinf 在这里很便宜；Cortex-M0 上浮点全部是软件模拟，差距远大于主机结果
+#include <math.h>
+#include "bench.h"
+#include "../user/rgb_led.c"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+#define PERIOD_MS  2000
+
+// 原实现的亮度公式 (0-255)
+static uint8_t _breath_sinf(uint32_t elapsed_time, uint32_t period)
+{
+    float angle = 2.0f * (float)M_PI * (float)(elapsed_time % period) / (float)period;
+    float brightness_factor = (sinf(angle - (float)M_PI / 2.0f) + 1.0f) / 2.0f;
+    return (uint8_t)(brightness_factor * 255.0f);
+}
+
+// 原实现写一个通道: 每次读 ARR 并做一次除法
+static void _set_pwm_by_color(TIM_HandleTypeDef *htim, uint32_t channel, uint8_t color_val)
+{
+    uint32_t max_duty = __HAL_TIM_GET_AUTORELOAD(htim);
+    __HAL_TIM_SET_COMPARE(htim, channel, ((uint32_t)color_val * max_duty) / 255);
+}
+
+int main(void)
+{
+    static TIM_HandleTypeDef htim;
+    static RGB_LED_t led;
+    uint8_t c;
+
+    TIM1->ARR = 999;
+    htim.Instance = TIM1;
+    RGB_LED_Init(&led, LED_CONNECTION_COMMON_CATHODE, &htim, TIM_CHANNEL_2, &htim, TIM_CHANNEL_3,
+                 &htim, TIM_CHANNEL_4);
+    RGB_LED_StartWhiteBreath(&led, PERIOD_MS);
+    RGB_LED_SetFrameInterval(&led, 1);
+
+    BENCH("breath level: sinf", 10000000,
+          bench_sink += _breath_sinf(i_, PERIOD_MS));
+    BENCH("breath level: Q15 table", 10000000,
+          bench_sink += _breath_level_q16(&led, i_));
+
+    // 每次调用前进 1ms (帧间隔 1ms)，每次都是渲染帧
+    BENCH("breath frame: sinf + 3x CCR (old Update)", 10000000,
+          c = _breath_sinf(i_, PERIOD_MS);
+          _set_pwm_by_color(&htim, TIM_CHANNEL_2, c);
+          _set_pwm_by_color(&htim, TIM_CHANNEL_3, c);
+          _set_pwm_by_color(&htim, TIM_CHANNEL_4, c));
+    BENCH("breath frame: RGB_LED_Update", 10000000,
+          uwTick++;
+          RGB_LED_Update(&led));
+    bench_sink += TIM1->CCR2 + led.frames_rendered;
+    return 0;
+}
@@ -0,0 +1,123 @@
+/* === C代码文件: bench_tick.c === */
+// TIM17 节拍中断从入口到进入 App_TickHandler 的耗时: HAL_TIM_IRQHandler 分发与 TICK_FAST_PATH 直接分发对比。
+// App_TickHandler 之后 (Kernel_Post、PendSV、Sched_Tick 到第一个任务) 两条路径完全相同，不在这里计时。
+// 按 Debug 预设以 -O0 编译 (见 CMakeLists.txt)。HAL_TIM_IRQHandler 按 STM32F0 HAL 的实现逐条转写:
+// 依次检查 CC1~CC4、更新、刹车、触发、换相标志，每个标志再检查中断使能。
+#include "stm32f0xx_hal.h"
+#include "bench.h"
+
+#define TIM_SR_CC1IF   0x0002u
+#define TIM_SR_CC2IF   0x0004u
+#define TIM_SR_CC3IF   0x0008u
+#define TIM_SR_CC4IF   0x0010u
+#define TIM_SR_COMIF   0x0020u
+#define TIM_SR_TIF     0x0040u
+#define TIM_SR_BIF     0x0080u
+#define TIM_CCMR1_CC1S 0x0003u
+#define TIM_CCMR1_CC2S 0x0300u
+#define TIM_CCMR2_CC3S 0x0003u
+#define TIM_CCMR2_CC4S 0x0300u
+
+// DIER 中断使能位与 SR 标志位位置相同
+#define __HAL_TIM_GET_FLAG(h, f)      (((h)->Instance->SR & (f)) == (f))
+#define __HAL_TIM_GET_IT_SOURCE(h, i) ((((h)->Instance->DIER & (i)) == (i)) ? 1 : 0)
+#define __HAL_TIM_CLEAR_IT(h, i)      ((h)->Instance->SR = ~(i))
+
+static TIM_HandleTypeDef htim17;
+static volatile uint32_t s_ticks;
+
+// 两条路径的共同终点 (main.c 中在这里投递节拍事件)
+static void App_TickHandler(void)
+{
+    s_ticks++;
+}
+
+// HAL 的弱回调 (工程中未实现，保持空函数)
+static void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) { (void)htim; }
+static void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim) { (void)htim; }
+static void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim) { (void)htim; }
+static void HAL_TIMEx_BreakCallback(TIM_HandleTypeDef *htim) { (void)htim; }
+static void HAL_TIM_TriggerCallback(TIM_HandleTypeDef *htim) { (void)htim; }
+static void HAL_TIMEx_CommutCallback(TIM_HandleTypeDef *htim) { (void)htim; }
+
+// main.c 的回调: 比较实例后进入节拍处理
+static void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM17) {
+        App_TickHandler();
+    }
+}
+
+// 一个捕获/比较通道的处理 (HAL 中四个通道各展开一次)
+#define HAL_TIM_CC(htim, flag, ccmr, ccs)                                   \
+    if (__HAL_TIM_GET_FLAG(htim, flag)) {                                   \
+        if (__HAL_TIM_GET_IT_SOURCE(htim, flag)) {                          \
+            __HAL_TIM_CLEAR_IT(htim, flag);                                 \
+            if ((htim)->Instance->ccmr & (ccs)) {                           \
+                HAL_TIM_IC_CaptureCallback(htim);                           \
+            } else {                                                        \
+                HAL_TIM_OC_DelayElapsedCallback(htim);                      \
+                HAL_TIM_PWM_PulseFinishedCallback(htim);                    \
+            }                                                               \
+        }                                                                   \
+    }
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+    HAL_TIM_CC(htim, TIM_SR_CC1IF, CCMR1, TIM_CCMR1_CC1S)
+    HAL_TIM_CC(htim, TIM_SR_CC2IF, CCMR1, TIM_CCMR1_CC2S)
+    HAL_TIM_CC(htim, TIM_SR_CC3IF, CCMR2, TIM_CCMR2_CC3S)
+    HAL_TIM_CC(htim, TIM_SR_CC4IF, CCMR2, TIM_CCMR2_CC4S)
+    if (__HAL_TIM_GET_FLAG(htim, TIM_SR_UIF)) {
+        if (__HAL_TIM_GET_IT_SOURCE(htim, TIM_DIER_UIE)) {
+            __HAL_TIM_CLEAR_IT(htim, TIM_SR_UIF);
+            HAL_TIM_PeriodElapsedCallback(htim);
+        }
+    }
+    if (__HAL_TIM_GET_FLAG(htim, TIM_SR_BIF)) {
+        if (__HAL_TIM_GET_IT_SOURCE(htim, TIM_SR_BIF)) {
+            __HAL_TIM_CLEAR_IT(htim, TIM_SR_BIF);
+            HAL_TIMEx_BreakCallback(htim);
+        }
+    }
+    if (__HAL_TIM_GET_FLAG(htim, TIM_SR_TIF)) {
+        if (__HAL_TIM_GET_IT_SOURCE(htim, TIM_SR_TIF)) {
+            __HAL_TIM_CLEAR_IT(htim, TIM_SR_TIF);
+            HAL_TIM_TriggerCallback(htim);
+        }
+    }
+    if (__HAL_TIM_GET_FLAG(htim, TIM_SR_COMIF)) {
+        if (__HAL_TIM_GET_IT_SOURCE(htim, TIM_SR_COMIF)) {
+            __HAL_TIM_CLEAR_IT(htim, TIM_SR_COMIF);
+            HAL_TIMEx_CommutCallback(htim);
+        }
+    }
+}
+
+// stm32f0xx_it.c 中 TICK_FAST_PATH 为 0/1 时的 TIM17_IRQHandler
+static void TIM17_IRQHandler_Hal(void)
+{
+    HAL_TIM_IRQHandler(&htim17);
+}
+
+static void TIM17_IRQHandler_Fast(void)
+{
+    TIM17->SR = ~TIM_SR_UIF;
+    App_TickHandler();
+}
+
+int main(void)
+{
+    htim17.Instance = TIM17;
+    TIM17->DIER = TIM_DIER_UIE;
+
+    // 每次操作: 硬件置位更新标志，然后进入中断处理
+    BENCH("TIM17 tick: HAL_TIM_IRQHandler", 10000000,
+          TIM17->SR |= TIM_SR_UIF;
+          TIM17_IRQHandler_Hal());
+    BENCH("TIM17 tick: TICK_FAST_PATH", 10000000,
+          TIM17->SR |= TIM_SR_UIF;
+          TIM17_IRQHandler_Fast());
+    bench_sink += s_ticks;
+    return 0;
+}
@@ -0,0 +1,38 @@
+/* === C代码文件: bench_ws2812.c === */
+// WS2812_Encode 每像素 (3个颜色字节 -> 12个 SPI 字节) 的耗时: 半字节查表与逐位编码对比
+#include "bench.h"
+#include "ws2812.h"
+
+// 逐位编码: 每个数据位判断一次，对照用
+static void _encode_bitwise(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+    while (len--) {
+        uint8_t v = *src++;
+        int bit;
+        for (bit = 7; bit >= 0; bit -= 2) {
+            *dst++ = (uint8_t)((((v >> bit) & 1u) ? 0xC0u : 0x80u) | (((v >> (bit - 1)) & 1u) ? 0x0Cu : 0x08u));
+        }
+    }
+}
+
+#define PIXELS  16
+
+int main(void)
+{
+    static uint8_t src[PIXELS * WS2812_BYTES_PER_PIXEL];
+    static uint8_t dst[sizeof(src) * WS2812_SPI_BYTES_PER_BYTE];
+    uint32_t i;
+
+    for (i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    // 每次操作编码一个像素，依次走遍 PIXELS 个像素
+    BENCH("WS2812_Encode (nibble table) / pixel", 1000000,
+          WS2812_Encode(&src[(i_ % PIXELS) * 3], WS2812_BYTES_PER_PIXEL, &dst[(i_ % PIXELS) * 12]);
+          bench_sink += dst[(i_ % PIXELS) * 12 + 5]);
+    BENCH("bitwise encode / pixel", 1000000,
+          _encode_bitwise(&src[(i_ % PIXELS) * 3], WS2812_BYTES_PER_PIXEL, &dst[(i_ % PIXELS) * 12]);
+          bench_sink += dst[(i_ % PIXELS) * 12 + 5]);
+    return 0;
+}
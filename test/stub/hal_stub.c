@@ -0,0 +1,70 @@
+/* === C代码文件: hal_stub.c === */
+// 主机测试用的外设实例和 HAL 函数: 寄存器是普通内存，HAL_GetTick 返回 uwTick (由测试推进)
+#include "stm32f0xx_hal.h"
+
+static GPIO_TypeDef s_gpioa, s_gpiob, s_gpioc;
+static TIM_TypeDef s_tim1, s_tim3, s_tim14, s_tim16, s_tim17;
+static EXTI_TypeDef s_exti;
+static SysTick_Type s_systick;
+static SCB_Type s_scb;
+static DMA_Channel_TypeDef s_dma1_ch2, s_dma1_ch3, s_dma1_ch5;
+static DMA_TypeDef s_dma1;
+static SPI_TypeDef s_spi1;
+static USART_TypeDef s_usart1;
+static RCC_TypeDef s_rcc;
+static PWR_TypeDef s_pwr;
+
+GPIO_TypeDef *GPIOA = &s_gpioa, *GPIOB = &s_gpiob, *GPIOC = &s_gpioc;
+TIM_TypeDef *TIM1 = &s_tim1, *TIM3 = &s_tim3, *TIM14 = &s_tim14, *TIM16 = &s_tim16, *TIM17 = &s_tim17;
+EXTI_TypeDef *EXTI = &s_exti;
+SysTick_Type *SysTick = &s_systick;
+SCB_Type *SCB = &s_scb;
+DMA_Channel_TypeDef *DMA1_Channel2 = &s_dma1_ch2, *DMA1_Channel3 = &s_dma1_ch3, *DMA1_Channel5 = &s_dma1_ch5;
+DMA_TypeDef *DMA1 = &s_dma1;
+SPI_TypeDef *SPI1 = &s_spi1;
+USART_TypeDef *USART1 = &s_usart1;
+RCC_TypeDef *RCC = &s_rcc;
+PWR_TypeDef *PWR = &s_pwr;
+
+uint32_t stub_primask;
+uint32_t stub_ipsr;
+void (*stub_wfi_hook)(void);
+
+volatile uint32_t uwTick;
+uint32_t SystemCoreClock = 48000000;
+
+uint32_t HAL_GetTick(void) { return uwTick; }
+void HAL_IncTick(void) { uwTick++; }
+void HAL_SuspendTick(void) {}
+void HAL_ResumeTick(void) {}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) { return SystemCoreClock; }
+uint32_t HAL_RCC_GetHCLKFreq(void) { return SystemCoreClock; }
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel) { (void)htim; (void)channel; return HAL_OK; }
+
+void NVIC_SetPendingIRQ(IRQn_Type irq) { (void)irq; }
+void NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+void NVIC_DisableIRQ(IRQn_Type irq) { (void)irq; }
+void NVIC_ClearPendingIRQ(IRQn_Type irq) { (void)irq; }
+void NVIC_SetPriority(IRQn_Type irq, uint32_t prio) { (void)irq; (void)prio; }
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t prio, uint32_t sub) { (void)irq; (void)prio; (void)sub; }
+void HAL_NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+void HAL_NVIC_DisableIRQ(IRQn_Type irq) { (void)irq; }
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin)
+{
+    return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    if (state) {
+        port->ODR |= pin;
+    } else {
+        port->ODR &= ~(uint32_t)pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin) { port->ODR ^= pin; }
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init) { (void)port; (void)init; }
@@ -0,0 +1,188 @@
+/* 主机测试用的 HAL/CMSIS 替身: 只包含 user/ 模块用到的类型、寄存器位和函数声明 */
+#ifndef STUB_HAL_H
+#define STUB_HAL_H
+#include <stdint.h>
+#include <stddef.h>
+#define __IO volatile
+typedef struct { __IO uint32_t MODER,OTYPER,OSPEEDR,PUPDR,IDR,ODR,BSRR,LCKR,AFR[2],BRR; } GPIO_TypeDef;
+typedef struct { __IO uint32_t CR1,CR2,SMCR,DIER,SR,EGR,CCMR1,CCMR2,CCER,CNT,PSC,ARR,RCR,CCR1,CCR2,CCR3,CCR4,BDTR,DCR,DMAR,OR; } TIM_TypeDef;
+typedef struct { __IO uint32_t IMR,EMR,RTSR,FTSR,SWIER,PR; } EXTI_TypeDef;
+typedef struct { __IO uint32_t CTRL,LOAD,VAL,CALIB; } SysTick_Type;
+typedef struct { __IO uint32_t CPUID,ICSR,RESERVED0,AIRCR,SCR,CCR,RESERVED1,SHP[2],SHCSR; } SCB_Type;
+typedef struct { __IO uint32_t CCR,CNDTR,CPAR,CMAR; } DMA_Channel_TypeDef;
+typedef struct { __IO uint32_t ISR,IFCR; } DMA_TypeDef;
+typedef struct { __IO uint32_t CR1,CR2,SR,DR,CRCPR,RXCRCR,TXCRCR,I2SCFGR,I2SPR; } SPI_TypeDef;
+typedef struct { __IO uint32_t CR1,CR2,CR3,BRR,GTPR,RTOR,RQR,ISR,ICR,RDR,TDR; } USART_TypeDef;
+typedef struct { __IO uint32_t CR,CFGR,CIR,APB2RSTR,APB1RSTR,AHBENR,APB2ENR,APB1ENR,BDCR,CSR,AHBRSTR,CFGR2,CFGR3,CR2; } RCC_TypeDef;
+typedef struct { __IO uint32_t CR, CSR; } PWR_TypeDef;
+// 外设实例为 hal_stub.c 中的全局变量，测试直接读写寄存器
+extern GPIO_TypeDef *GPIOA, *GPIOB, *GPIOC;
+extern TIM_TypeDef *TIM1, *TIM3, *TIM14, *TIM16, *TIM17;
+extern EXTI_TypeDef *EXTI; extern SysTick_Type *SysTick; extern SCB_Type *SCB;
+extern DMA_Channel_TypeDef *DMA1_Channel2, *DMA1_Channel3, *DMA1_Channel5; extern DMA_TypeDef *DMA1;
+extern SPI_TypeDef *SPI1; extern USART_TypeDef *USART1; extern RCC_TypeDef *RCC; extern PWR_TypeDef *PWR;
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+typedef enum { HAL_OK, HAL_ERROR } HAL_StatusTypeDef;
+typedef struct { uint32_t Prescaler, CounterMode, Period, ClockDivision, RepetitionCounter, AutoReloadPreload; } TIM_Base_InitTypeDef;
+typedef struct { TIM_TypeDef *Instance; TIM_Base_InitTypeDef Init; } TIM_HandleTypeDef;
+typedef struct { uint32_t Pin, Mode, Pull, Speed, Alternate; } GPIO_InitTypeDef;
+typedef int IRQn_Type;
+#define GPIO_PIN_3 0x8u
+#define GPIO_PIN_4 0x10u
+#define GPIO_PIN_7 0x80u
+#define GPIO_PIN_8 0x100u
+#define GPIO_PIN_13 0x2000u
+#define TIM_CHANNEL_1 0x0u
+#define TIM_CHANNEL_2 0x4u
+#define TIM_CHANNEL_3 0x8u
+#define TIM_CHANNEL_4 0xCu
+#define GPIO_MODE_AF_PP 2u
+#define GPIO_MODE_OUTPUT_PP 1u
+#define GPIO_NOPULL 0u
+#define GPIO_SPEED_FREQ_HIGH 3u
+#define GPIO_AF0_SPI1 0u
+#define GPIO_AF0_USART1 0u
+#define TIM17_IRQn 22
+#define TIM14_IRQn 19
+#define TIM3_IRQn 16
+#define EXTI2_3_IRQn 6
+#define EXTI4_15_IRQn 7
+#define DMA1_Channel2_3_IRQn 10
+#define DMA1_Channel4_5_IRQn 11
+#define PendSV_IRQn (-2)
+#define __HAL_TIM_GET_AUTORELOAD(h) ((h)->Instance->ARR)
+#define __HAL_TIM_SET_COMPARE(h,c,v) ((&(h)->Instance->CCR1)[(c) >> 2] = (v))
+#define __HAL_TIM_GET_COMPARE(h,c) ((&(h)->Instance->CCR1)[(c) >> 2])
+#define __HAL_TIM_GET_COUNTER(h) ((h)->Instance->CNT)
+#define TIM_SR_UIF 1u
+#define TIM_DIER_UIE 1u
+#define TIM_DIER_UDE 0x100u
+#define TIM_CR1_CEN 1u
+#define TIM_CR1_OPM 8u
+#define TIM_CR1_URS 4u
+#define TIM_CR1_ARPE 0x80u
+#define TIM_EGR_UG 1u
+#define TIM_CCER_CC2P 0x20u
+#define TIM_CCER_CC3P 0x200u
+#define TIM_CCER_CC4P 0x2000u
+#define SCB_ICSR_PENDSVSET_Msk (1u<<28)
+#define SCB_SCR_SLEEPDEEP_Msk 4u
+#define SysTick_CTRL_TICKINT_Msk 2u
+#define SysTick_CTRL_ENABLE_Msk 1u
+#define RCC_APB1ENR_TIM3EN 2u
+#define RCC_APB1ENR_TIM14EN 0x100u
+#define RCC_APB2ENR_SPI1EN 0x1000u
+#define RCC_APB2ENR_USART1EN 0x4000u
+#define RCC_AHBENR_DMA1EN 1u
+#define __HAL_RCC_DMA1_CLK_ENABLE() (RCC->AHBENR |= 1u)
+#define __HAL_RCC_TIM14_CLK_ENABLE() (RCC->APB1ENR |= 1u)
+#define __HAL_RCC_TIM3_CLK_ENABLE() (RCC->APB1ENR |= 1u)
+#define __HAL_RCC_SPI1_CLK_ENABLE() (RCC->APB2ENR |= 1u)
+#define __HAL_RCC_USART1_CLK_ENABLE() (RCC->APB2ENR |= 1u)
+#define __HAL_RCC_GPIOA_CLK_ENABLE() (RCC->AHBENR |= 1u)
+#define __HAL_RCC_GPIOB_CLK_ENABLE() (RCC->AHBENR |= 1u)
+#define DMA_CCR_EN 1u
+#define DMA_CCR_TCIE 2u
+#define DMA_CCR_HTIE 4u
+#define DMA_CCR_DIR 0x10u
+#define DMA_CCR_CIRC 0x20u
+#define DMA_CCR_MINC 0x80u
+#define DMA_CCR_PSIZE_0 0x100u
+#define DMA_CCR_MSIZE_0 0x400u
+#define DMA_CCR_PL_1 0x2000u
+#define DMA_ISR_TCIF2 0x20u
+#define DMA_ISR_HTIF2 0x40u
+#define DMA_ISR_TCIF3 0x200u
+#define DMA_ISR_HTIF3 0x400u
+#define DMA_ISR_TCIF5 0x20000u
+#define DMA_ISR_HTIF5 0x40000u
+#define DMA_IFCR_CGIF2 0x10u
+#define DMA_IFCR_CGIF3 0x100u
+#define DMA_IFCR_CTCIF3 0x200u
+#define DMA_IFCR_CHTIF3 0x400u
+#define DMA_IFCR_CGIF5 0x10000u
+#define SPI_CR1_MSTR 4u
+#define SPI_CR1_BR_0 0x8u
+#define SPI_CR1_BR_1 0x10u
+#define SPI_CR1_SSM 0x200u
+#define SPI_CR1_SSI 0x100u
+#define SPI_CR1_SPE 0x40u
+#define SPI_CR2_TXDMAEN 2u
+#define SPI_CR2_DS_Pos 8u
+#define SPI_SR_BSY 0x80u
+#define SPI_SR_FTLVL 0x1800u
+#define USART_CR1_UE 1u
+#define USART_CR1_TE 8u
+#define USART_CR3_DMAT 0x80u
+#define USART_ISR_TXE 0x80u
+#define USART_ISR_TC 0x40u
+#define USART_ICR_TCCF 0x40u
+#define PWR_CR_LPDS 1u
+#define PWR_CR_PDDS 2u
+// PRIMASK/IPSR 为全局变量，__WFI 调用 stub_wfi_hook (为空时直接返回)，供测试模拟中断和休眠
+extern uint32_t stub_primask, stub_ipsr;
+extern void (*stub_wfi_hook)(void);
+static inline uint32_t __get_PRIMASK(void){return stub_primask;}
+static inline uint32_t __get_IPSR(void){return stub_ipsr;}
+static inline void __disable_irq(void){stub_primask = 1;}
+static inline void __enable_irq(void){stub_primask = 0;}
+static inline void __set_PRIMASK(uint32_t x){stub_primask = x;}
+static inline void __DMB(void){}
+static inline void __DSB(void){}
+static inline void __ISB(void){}
+static inline void __WFI(void){if (stub_wfi_hook) stub_wfi_hook();}
+static inline void __NOP(void){}
+static inline uint32_t __get_MSP(void){return 0;}
+void NVIC_SetPendingIRQ(IRQn_Type); void NVIC_EnableIRQ(IRQn_Type); void NVIC_DisableIRQ(IRQn_Type); void NVIC_ClearPendingIRQ(IRQn_Type);
+void NVIC_SetPriority(IRQn_Type, uint32_t);
+uint32_t HAL_GetTick(void);
+void HAL_SuspendTick(void); void HAL_ResumeTick(void); void HAL_IncTick(void);
+extern volatile uint32_t uwTick;
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef*, uint16_t);
+void HAL_GPIO_WritePin(GPIO_TypeDef*, uint16_t, GPIO_PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef*, uint16_t);
+void HAL_GPIO_Init(GPIO_TypeDef*, GPIO_InitTypeDef*);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef*, uint32_t);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef*);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef*);
+void HAL_NVIC_SetPriority(IRQn_Type, uint32_t, uint32_t); void HAL_NVIC_EnableIRQ(IRQn_Type); void HAL_NVIC_DisableIRQ(IRQn_Type);
+void HAL_PWR_EnterSLEEPMode(uint32_t, uint8_t); void HAL_PWR_EnterSTOPMode(uint32_t, uint8_t);
+#define PWR_MAINREGULATOR_ON 0u
+#define PWR_LOWPOWERREGULATOR_ON 1u
+#define PWR_SLEEPENTRY_WFI 1u
+#define PWR_STOPENTRY_WFI 1u
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000u
+#define TIM_IT_UPDATE 1u
+#define __HAL_TIM_ENABLE_IT(h,i) ((h)->Instance->DIER |= (i))
+#define __HAL_TIM_DISABLE_IT(h,i) ((h)->Instance->DIER &= ~(i))
+#define __HAL_TIM_ENABLE(h) ((h)->Instance->CR1 |= 1u)
+#define __HAL_TIM_DISABLE(h) ((h)->Instance->CR1 &= ~1u)
+void HAL_GPIO_EXTI_IRQHandler(uint16_t);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef*);
+HAL_StatusTypeDef HAL_Init(void);
+typedef struct { uint32_t OscillatorType, HSIState, HSICalibrationValue; struct { uint32_t PLLState, PLLSource, PLLMUL, PREDIV; } PLL; } RCC_OscInitTypeDef;
+typedef struct { uint32_t ClockType, SYSCLKSource, AHBCLKDivider, APB1CLKDivider; } RCC_ClkInitTypeDef;
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef*); HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef*, uint32_t);
+#define RCC_OSCILLATORTYPE_HSI 2u
+#define RCC_HSI_ON 1u
+#define RCC_HSICALIBRATION_DEFAULT 16u
+#define RCC_PLL_ON 2u
+#define RCC_PLLSOURCE_HSI 0u
+#define RCC_PLL_MUL12 0u
+#define RCC_PREDIV_DIV1 0u
+#define RCC_CLOCKTYPE_HCLK 2u
+#define RCC_CLOCKTYPE_SYSCLK 1u
+#define RCC_CLOCKTYPE_PCLK1 4u
+#define RCC_SYSCLKSOURCE_PLLCLK 2u
+#define RCC_SYSCLK_DIV1 0u
+#define RCC_HCLK_DIV1 0u
+#define FLASH_LATENCY_1 1u
+#define TIM_DMABASE_CCR2 0x0000000Eu
+#define TIM_DMABURSTLENGTH_3TRANSFERS 0x00000200u
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+extern uint32_t SystemCoreClock;
+#define SysTick_CTRL_CLKSOURCE_Msk 4u
+#define SysTick_LOAD_RELOAD_Msk 0xFFFFFFu
+#define SCB_ICSR_PENDSTCLR_Msk (1u<<25)
+#endif
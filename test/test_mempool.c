@@ -0,0 +1,107 @@
+/* === C代码文件: test_mempool.c === */
+// mempool.c 的主机测试: 按字节数选择尺寸等级、用完时借用更大的等级、按地址释放，
+// 以及 newlib 的 _malloc_r 系列 (__wrap__*_r) 由池实现
+#include <stdio.h>
+#include <string.h>
+#include "mempool.h"
+
+static int s_failed;
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); s_failed++; } } while (0)
+
+struct _reent;
+void *__wrap__malloc_r(struct _reent *r, size_t size);
+void __wrap__free_r(struct _reent *r, void *p);
+void *__wrap__calloc_r(struct _reent *r, size_t n, size_t size);
+void *__wrap__realloc_r(struct _reent *r, void *p, size_t size);
+
+// 地址落在哪个等级的存储区，不属于任何等级返回 -1
+static int _class_of(const void *p)
+{
+    int i;
+
+    for (i = 0; i < MEMPOOL_CLASS_COUNT; i++) {
+        const MemPool_t *pool = Mem_Pool((MemPool_Class_t)i);
+        if ((const uint8_t *)p >= pool->base && (const uint8_t *)p < pool->base + pool->block_size * pool->count) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void test_classes(void)
+{
+    void *small[MEMPOOL_SMALL_COUNT], *borrowed, *p;
+    int i;
+
+    Mem_Init();
+    for (i = 0; i < MEMPOOL_SMALL_COUNT; i++) {
+        small[i] = Mem_Alloc(MEMPOOL_SMALL_SIZE);
+        CHECK(_class_of(small[i]) == MEMPOOL_SMALL);
+        CHECK(((uintptr_t)small[i] & 3u) == 0);
+    }
+    // 小块用完时借用中块，只有合适的等级计入失败次数
+    borrowed = Mem_Alloc(1);
+    CHECK(_class_of(borrowed) == MEMPOOL_MEDIUM);
+    CHECK(Mem_Pool(MEMPOOL_SMALL)->fails == 1);
+    CHECK(Mem_Pool(MEMPOOL_MEDIUM)->fails == 0);
+
+    CHECK(Mem_Alloc(MEMPOOL_LARGE_SIZE + 1) == 0);
+    p = Mem_Alloc(MEMPOOL_LARGE_SIZE);
+    CHECK(_class_of(p) == MEMPOOL_LARGE);
+
+    Mem_Free(borrowed);
+    Mem_Free(p);
+    for (i = 0; i < MEMPOOL_SMALL_COUNT; i++) {
+        Mem_Free(small[i]);
+    }
+    Mem_Free(0);
+    for (i = 0; i < MEMPOOL_CLASS_COUNT; i++) {
+        CHECK(Mem_Pool((MemPool_Class_t)i)->used == 0);
+    }
+    CHECK(Mem_Pool(MEMPOOL_SMALL)->peak == MEMPOOL_SMALL_COUNT);
+}
+
+static void test_newlib_wrappers(void)
+{
+    uint8_t *p, *q;
+    size_t i;
+
+    Mem_Init();
+    p = __wrap__malloc_r(0, 10);
+    CHECK(_class_of(p) == MEMPOOL_SMALL);
+    memset(p, 0xAB, 10);
+
+    // 原块放得下时原地返回，放不下时换到更大的等级并保留内容
+    CHECK(__wrap__realloc_r(0, p, MEMPOOL_SMALL_SIZE) == p);
+    q = __wrap__realloc_r(0, p, MEMPOOL_SMALL_SIZE + 1);
+    CHECK(_class_of(q) == MEMPOOL_MEDIUM);
+    for (i = 0; i < 10; i++) {
+        CHECK(q[i] == 0xAB);
+    }
+    CHECK(Mem_Pool(MEMPOOL_SMALL)->used == 0);
+    CHECK(__wrap__realloc_r(0, q, MEMPOOL_LARGE_SIZE + 1) == 0);
+    CHECK(Mem_Pool(MEMPOOL_MEDIUM)->used == 1);
+    __wrap__free_r(0, q);
+
+    p = __wrap__calloc_r(0, 4, 8);
+    CHECK(p != 0);
+    for (i = 0; i < 32; i++) {
+        CHECK(p[i] == 0);
+    }
+    __wrap__free_r(0, p);
+    CHECK(__wrap__calloc_r(0, SIZE_MAX / 2, 4) == 0);
+
+    // stdout 申请 BUFSIZ 缓冲失败，newlib 改为无缓冲
+    CHECK(__wrap__malloc_r(0, 1024) == 0);
+    for (i = 0; i < MEMPOOL_CLASS_COUNT; i++) {
+        CHECK(Mem_Pool((MemPool_Class_t)i)->used == 0);
+    }
+}
+
+int main(void)
+{
+    test_classes();
+    test_newlib_wrappers();
+    printf("test_mempool: %s\n", s_failed ? "FAILED" : "ok");
+    return s_failed != 0;
+}
@@ -0,0 +1,276 @@
+/* === C代码文件: test_rgb_led.c === */
+// rgb_led.c 的 DMA 回放主机测试: 按 1ms 一个 PWM 周期模拟 TIM1 更新事件、重复计数器和 DMA1 通道5 的循环传输，
+// 检查循环回放的周期与 CPU 更新一致 (不逐圈漂移)，帧间隔不比 CPU 更新长，中途启动时从当前相位开始，
+// 以及合成器的上层图层到期或隐藏后，DMA 回放的下层效果按原时间轴继续
+#include <stdio.h>
+#include <string.h>
+#include "../user/rgb_led.c"
+#include "led_compositor.h"
+
+static int s_failed;
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); s_failed++; } } while (0)
+
+static TIM_HandleTypeDef s_htim1;
+static RGB_LED_t s_led;
+static LED_Compositor_t *s_comp;   // 非空时每个 PWM 周期先调用一次合成器
+
+// --- TIM1 + DMA1 通道5 ---
+
+static uint32_t s_base;     // 通道5 配置时的 CMAR (相对 s_dma_frames 的半字偏移)
+static uint32_t s_reload;   // 通道5 配置时写入的 CNDTR，循环模式下计数到0后重装
+static uint32_t s_rep;      // 重复计数器: 为0时的更新事件触发一次 DMA burst
+static uint8_t s_flipped;   // 本帧传输完成中断翻转了输出极性
+
+// 软件写 CGIF5 说明刚 (重新) 配置过通道5，锁存新的起始地址和传输数
+static uint8_t _dma_latch(void)
+{
+    uint8_t configured = (DMA1->IFCR & DMA_IFCR_CGIF5) != 0;
+
+    if (configured) {
+        s_base = (DMA1_Channel5->CMAR - (uint32_t)(uintptr_t)s_dma_frames) / sizeof(uint16_t);
+        s_reload = DMA1_Channel5->CNDTR;
+    }
+    DMA1->IFCR = 0;
+    return configured;
+}
+
+// 推进一个 PWM 周期 (TIM1 48MHz / 48 / 1000 = 1kHz，即 1ms)
+static void _pwm_cycle(void)
+{
+    if (_dma_latch()) {
+        s_rep = 0;
+    }
+    s_flipped = 0;
+
+    if ((DMA1_Channel5->CCR & DMA_CCR_EN) && (TIM1->DIER & TIM_DIER_UDE)) {
+        if (s_rep == 0 && DMA1_Channel5->CNDTR) {
+            const uint16_t *frame = &s_dma_frames[0][0] + s_base + (s_reload - DMA1_Channel5->CNDTR);
+            uint32_t ccer = TIM1->CCER;
+            TIM1->CCR2 = frame[0];
+            TIM1->CCR3 = frame[1];
+            TIM1->CCR4 = frame[2];
+            DMA1_Channel5->CNDTR -= 3;
+            if (DMA1_Channel5->CNDTR == 0) {
+                if (DMA1_Channel5->CCR & DMA_CCR_CIRC) {
+                    DMA1_Channel5->CNDTR = s_reload;
+                }
+                if (DMA1_Channel5->CCR & DMA_CCR_TCIE) {
+                    DMA1->ISR |= DMA_ISR_TCIF5;
+                    RGB_LED_DMA_IRQHandler();
+                    DMA1->ISR = 0;
+                    _dma_latch();
+                }
+            }
+            s_flipped = (TIM1->CCER != ccer);
+        }
+        s_rep = (s_rep + 1) % (TIM1->RCR + 1);
+    }
+    uwTick++;
+}
+
+// 通道 R 的实际高电平宽度 (计数值)，输出极性被翻转时取互补
+static uint32_t _output_r(void)
+{
+    if (TIM1->CCER & TIM_CCER_CC2P) {
+        return TIM1->ARR + 1 - TIM1->CCR2;
+    }
+    return TIM1->CCR2;
+}
+
+// CPU 更新在 t 时刻 (效果启动以来的毫秒数) 写入通道 R 的比较值
+static uint32_t _expected_r(uint32_t t)
+{
+    uint8_t rgb[3];
+
+    if (s_led.mode == LED_MODE_BREATH) {
+        if (s_led.playback == LED_PLAYBACK_DMA_HALF) {
+            return (_breath_level_q16(&s_led, t) * s_led.max_duty_r + 0x8000u) >> 16;
+        }
+        return _duty_to_compare(s_led.max_duty_r, _cie_interp_q16(_breath_level_q16(&s_led, t)),
+                                s_led.connection_type);
+    }
+    _render_color(&s_led, t, rgb);
+    return _color_to_compare(s_led.max_duty_r, rgb[0], s_led.connection_type);
+}
+
+static uint32_t _abs_diff(uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+// 运行 ms 个 PWM 周期，在每帧开始的周期比较输出与 CPU 更新的结果，返回最大偏差。
+// 半周期模式的极性在最后一帧传出时就翻转，这一帧在 y = 1/2 附近，不参与比较
+static uint32_t _run(uint32_t ms)
+{
+    uint32_t worst = 0, k;
+
+    for (k = 0; k < ms; k++) {
+        uint32_t t = HAL_GetTick() - s_led.timer_start;
+        uint8_t frame_start;
+        if (s_comp) {
+            LED_Compositor_Update(s_comp);
+            t = HAL_GetTick() - s_led.timer_start;
+        }
+        frame_start = (s_rep == 0);
+        _pwm_cycle();
+        if (frame_start && !s_flipped) {
+            uint32_t d = _abs_diff(_output_r(), _expected_r(t));
+            if (d > worst) {
+                worst = d;
+            }
+        }
+    }
+    return worst;
+}
+
+// frame_ms: LED 的帧间隔，DMA 帧间隔不能比它长
+static void _reset_with_frame(LED_Playback_t playback, uint32_t frame_ms)
+{
+    memset(TIM1, 0, sizeof(*TIM1));
+    memset(DMA1, 0, sizeof(*DMA1));
+    memset(DMA1_Channel5, 0, sizeof(*DMA1_Channel5));
+    TIM1->PSC = 47;
+    TIM1->ARR = 999;
+    uwTick = 1000;
+    s_htim1.Instance = TIM1;
+    RGB_LED_Init(&s_led, LED_CONNECTION_COMMON_CATHODE, &s_htim1, TIM_CHANNEL_2, &s_htim1, TIM_CHANNEL_3,
+                 &s_htim1, TIM_CHANNEL_4);
+    RGB_LED_SetFrameInterval(&s_led, frame_ms);
+    RGB_LED_SetPlayback(&s_led, playback);
+}
+
+// 下面的周期/相位测试放宽到 50ms 帧间隔，使 2s 呼吸也能由 64 帧缓冲区回放
+static void _reset(LED_Playback_t playback)
+{
+    _reset_with_frame(playback, 50);
+}
+
+// 帧数 * (RCR+1) 必须正好是一个周期 (半周期模式为半个)，回放多圈后仍与 CPU 更新逐帧一致
+static void test_period(void)
+{
+    static const struct { uint8_t breath; uint32_t on, off; } c[] = {
+        { 1, 2000, 0 }, { 0, 200, 200 }, { 0, 300, 500 }, { 1, 1500, 0 },
+    };
+    uint32_t i;
+
+    for (i = 0; i < sizeof(c) / sizeof(c[0]); i++) {
+        _reset(LED_PLAYBACK_DMA);
+        if (c[i].breath) {
+            RGB_LED_StartWhiteBreath(&s_led, c[i].on);
+        } else {
+            RGB_LED_StartFlash(&s_led, 255, 0, 0, c[i].on, c[i].off);
+        }
+        CHECK(s_led.dma_running);
+        CHECK(DMA1_Channel5->CNDTR / 3 * (TIM1->RCR + 1) == s_led.period);
+        CHECK(DMA1_Channel5->CNDTR / 3 <= RGB_LED_DMA_MAX_FRAMES);
+        CHECK(_run(s_led.period * 20) <= (c[i].breath ? 2u : 0u));
+    }
+}
+
+// 周期不是整数个 PWM 周期时 DMA 无法按整数帧循环，退回 CPU 更新
+static void test_inexact_falls_back(void)
+{
+    _reset(LED_PLAYBACK_DMA);
+    TIM1->ARR = 2999;   // 333.33Hz
+    RGB_LED_RefreshTimebase(&s_led);
+    RGB_LED_StartWhiteBreath(&s_led, 2000);
+    CHECK(!s_led.dma_running);
+    CHECK(RGB_LED_IsAnimating(&s_led));
+}
+
+// DMA 帧间隔比 LED 的帧间隔长时退回 CPU 更新，默认 10ms 帧间隔下 2s 呼吸 (需要 200 帧) 不走 DMA
+static void test_frame_interval(void)
+{
+    _reset_with_frame(LED_PLAYBACK_DMA, RGB_LED_DEFAULT_FRAME_MS);
+    RGB_LED_StartWhiteBreath(&s_led, 2000);
+    CHECK(!s_led.dma_running);
+
+    RGB_LED_StartFlash(&s_led, 255, 0, 0, 200, 200);
+    CHECK(s_led.dma_running);
+    CHECK(TIM1->RCR + 1 <= RGB_LED_DEFAULT_FRAME_MS);
+    CHECK(_run(s_led.period * 5) == 0);
+
+    // 半周期模式 20ms 一帧正好放得下
+    _reset_with_frame(LED_PLAYBACK_DMA_HALF, 20);
+    RGB_LED_StartWhiteBreath(&s_led, 2000);
+    CHECK(s_led.dma_running);
+    CHECK(TIM1->RCR + 1 == 20);
+    _reset_with_frame(LED_PLAYBACK_DMA_HALF, 19);
+    RGB_LED_StartWhiteBreath(&s_led, 2000);
+    CHECK(!s_led.dma_running);
+}
+
+// 效果运行到一半才切换为 DMA 回放: 第0帧就是当前相位，而不是从周期起点重新开始
+static void test_phase(LED_Playback_t playback, uint8_t breath)
+{
+    uint32_t k;
+
+    _reset(LED_PLAYBACK_CPU);
+    if (breath) {
+        RGB_LED_StartWhiteBreath(&s_led, 2000);
+    } else {
+        RGB_LED_StartFlash(&s_led, 255, 0, 0, 200, 200);
+    }
+    for (k = 0; k < 1737; k++) {
+        RGB_LED_Update(&s_led);
+        _pwm_cycle();
+    }
+    RGB_LED_SetPlayback(&s_led, playback);
+    CHECK(s_led.dma_running);
+    // 半周期模式的缓冲区不能旋转，首圈从最近的帧开始，相位误差不超过半帧
+    // (20ms 一帧时 10ms，呼吸最陡处约 16 个计数)；整周期模式从当前时刻开始渲染，与 CPU 更新一致
+    CHECK(_run(s_led.period * 5) <= (playback == LED_PLAYBACK_DMA_HALF ? 16u : breath ? 2u : 0u));
+    CHECK(s_led.dma_running);
+}
+
+// 合成器: 底层呼吸由 DMA 回放，告警层闪烁到期/被隐藏后，底层按原来的时间轴继续，而不是从相位0重新开始
+static void test_compositor_resume(LED_Playback_t playback)
+{
+    static LED_Compositor_t comp;
+    RGB_LED_t *bg, *alert;
+    uint32_t tol = playback == LED_PLAYBACK_DMA_HALF ? 16u : 2u;
+
+    _reset(playback);
+    LED_Compositor_Init(&comp, &s_led);
+    s_comp = &comp;
+    bg = LED_Compositor_Layer(&comp, LED_LAYER_BACKGROUND);
+    alert = LED_Compositor_Layer(&comp, LED_LAYER_ALERT);
+
+    RGB_LED_StartWhiteBreath(bg, 2000);
+    LED_Compositor_Show(&comp, LED_LAYER_BACKGROUND, LED_ALPHA_OPAQUE, 0);
+    CHECK(_run(1300) <= tol);
+    CHECK(s_led.dma_running);
+
+    // 告警层 600ms 后到期
+    RGB_LED_StartFlash(alert, 255, 0, 0, 50, 50);
+    LED_Compositor_Show(&comp, LED_LAYER_ALERT, LED_ALPHA_OPAQUE, 600);
+    CHECK(_run(300) == 0);
+    CHECK(s_led.mode == LED_MODE_FLASH && s_led.dma_running);
+    _run(400);
+    CHECK(s_led.mode == LED_MODE_BREATH && s_led.dma_running);
+    CHECK(s_led.timer_start == bg->timer_start);
+    CHECK(_run(4000) <= tol);
+
+    // 再显示一次并提前隐藏
+    RGB_LED_StartFlash(alert, 0, 255, 0, 100, 100);
+    LED_Compositor_Show(&comp, LED_LAYER_ALERT, LED_ALPHA_OPAQUE, 0);
+    _run(777);
+    LED_Compositor_Hide(&comp, LED_LAYER_ALERT);
+    CHECK(_run(4000) <= tol);
+    CHECK(s_led.timer_start == bg->timer_start);
+    s_comp = 0;
+}
+
+int main(void)
+{
+    test_period();
+    test_inexact_falls_back();
+    test_frame_interval();
+    test_phase(LED_PLAYBACK_DMA, 1);
+    test_phase(LED_PLAYBACK_DMA, 0);
+    test_phase(LED_PLAYBACK_DMA_HALF, 1);
+    test_compositor_resume(LED_PLAYBACK_DMA);
+    test_compositor_resume(LED_PLAYBACK_DMA_HALF);
+    printf("test_rgb_led: %s\n", s_failed ? "FAILED" : "ok");
+    return s_failed != 0;
+}
@@ -0,0 +1,198 @@
+/* === C代码文件: test_tickless.c === */
+// 无节拍空闲的虚拟时间测试: 按 main.c 的 Idle_Sleep 流程运行调度器和软件定时器一小时，
+// TIM17 和唤醒源按微秒级虚拟时间模拟，统计唤醒次数，并检查每次休眠后以及一小时后 HAL tick 与真实时间一致
+#include <stdio.h>
+#include <string.h>
+#include "tickless.h"
+#include "scheduler.h"
+#include "soft_timer.h"
+
+static int s_failed;
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); s_failed++; } } while (0)
+
+#define HOUR_US        3600000000ull
+#define DUMP_PERIOD_MS 10000        // 与 main.c 的周期输出定时器相同
+
+static TIM_HandleTypeDef s_htim17;
+
+static uint64_t s_now_us;       // 虚拟时间
+static uint64_t s_tick_origin;  // 最近一次更新事件 (CNT 回到0) 的时刻
+static uint64_t s_next_uev;     // 下一次更新事件的时刻
+static uint64_t s_next_exti;    // 下一次按键边沿，UINT64_MAX 表示没有
+static uint64_t s_exti_period;
+static uint8_t s_exti_pending;
+
+// --- TIM17 与 WFI ---
+
+static uint64_t _us_per_count(void)
+{
+    return (uint64_t)(TIM17->PSC + 1) * 1000000u / SystemCoreClock;
+}
+
+// WFI: 跳到下一次更新事件或按键边沿中较早的一个。TIM17 连续计数，关 ARPE 时写入的 ARR 立即决定下一次更新事件；
+// 更新事件时计数器回到0，UIF 置位，之后按当时的 ARR (预装载值已生效) 计数
+static void _wfi(void)
+{
+    if (!(TIM17->CR1 & TIM_CR1_ARPE)) {
+        s_next_uev = s_tick_origin + (uint64_t)(TIM17->ARR + 1) * _us_per_count();
+    }
+    if (s_next_exti < s_next_uev) {
+        s_now_us = s_next_exti;
+        s_exti_pending = 1;
+        s_next_exti = s_exti_period ? s_now_us + s_exti_period : UINT64_MAX;
+    } else {
+        s_now_us = s_next_uev;
+        s_tick_origin = s_now_us;
+        s_next_uev = s_now_us + (uint64_t)(TIM17->ARR + 1) * _us_per_count();
+        TIM17->SR |= TIM_SR_UIF;
+    }
+    TIM17->CNT = (uint32_t)((s_now_us - s_tick_origin) / _us_per_count());
+}
+
+// 休眠返回后 TIM17 须回到节拍周期 (预装载)。提前唤醒时当前周期结束在正在走的这一毫秒末尾；
+// 更新事件已经发生时 ARR 已立即改回，下一次更新事件在 1ms 后
+static void _after_restore(void)
+{
+    CHECK(TIM17->CR1 & TIM_CR1_ARPE);
+    CHECK(TIM17->PSC == s_htim17.Init.Prescaler && TIM17->ARR == s_htim17.Init.Period);
+    if (TIM17->SR & TIM_SR_UIF) {
+        s_next_uev = s_tick_origin + 1000u;
+    } else {
+        s_next_uev = s_tick_origin + ((s_now_us - s_tick_origin) / 1000u + 1) * 1000u;
+    }
+}
+
+// --- 被调度的工作 (与 main.c 相同的两张任务表；LED 效果都由 DMA 回放时渲染任务无事可做，这里按此情形) ---
+
+static Sched_t s_input, s_render;
+static uint32_t s_dump_count, s_dump_late;
+
+static void Task_SoftTimer(void *arg) { (void)arg; SoftTimer_Tick(); }
+static uint32_t Task_SoftTimerIdle(void *arg) { (void)arg; return SoftTimer_NextDeadline(); }
+static void Task_Led(void *arg) { (void)arg; }
+static uint32_t Task_LedIdle(void *arg) { (void)arg; return UINT32_MAX; }
+
+static const Sched_Task_t s_input_tasks[] = { { Task_SoftTimer, 0, 1, 0, Task_SoftTimerIdle } };
+static const Sched_Task_t s_render_tasks[] = { { Task_Led, 0, 10, 2, Task_LedIdle } };
+static Sched_TaskStats_t s_input_stats[1], s_render_stats[1];
+
+// 周期输出定时器: 检查回调时的 HAL tick 与虚拟时间一致
+static void _dump_timer(void *arg)
+{
+    (void)arg;
+    s_dump_count++;
+    if ((uint64_t)HAL_GetTick() * 1000u > s_now_us || s_now_us - (uint64_t)HAL_GetTick() * 1000u >= 1000u) {
+        s_dump_late++;
+    }
+}
+
+// 节拍中断: 统一时基下推进 HAL tick，然后执行到期任务 (main.c 中经内核任务执行，顺序相同)
+static void _tick_isr(void)
+{
+    HAL_IncTick();
+    Sched_Tick(&s_input);
+    Sched_Tick(&s_render);
+}
+
+// --- 一小时的主循环 ---
+
+typedef struct {
+    uint32_t wakeups;        // 从 WFI 醒来的次数
+    uint32_t sleeps;         // 无节拍休眠次数
+    uint32_t worst_error_us; // 单次休眠后 HAL tick 与真实经过时间之差的最大值
+} Run_t;
+
+static void _run_hour(Run_t *r, uint64_t exti_period_us, uint64_t exti_first_us)
+{
+    memset(r, 0, sizeof(*r));
+    s_now_us = 0;
+    s_tick_origin = 0;
+    s_next_uev = 1000u;
+    s_exti_pending = 0;
+    s_exti_period = exti_period_us;
+    s_next_exti = exti_period_us ? exti_first_us : UINT64_MAX;
+    uwTick = 0;
+    memset(TIM17, 0, sizeof(*TIM17));
+    TIM17->PSC = s_htim17.Init.Prescaler;
+    TIM17->ARR = s_htim17.Init.Period;
+    TIM17->CR1 = TIM_CR1_CEN | TIM_CR1_ARPE;
+    stub_wfi_hook = _wfi;
+
+    SoftTimer_Init();
+    SoftTimer_Start(SoftTimer_Create(_dump_timer, 0), DUMP_PERIOD_MS, DUMP_PERIOD_MS);
+    Sched_Init(&s_input, s_input_tasks, s_input_stats, 1);
+    Sched_Init(&s_render, s_render_tasks, s_render_stats, 1);
+    s_dump_count = s_dump_late = 0;
+
+    while (s_now_us < HOUR_US) {
+        // 与 main.c 的 Idle_Sleep 相同
+        uint32_t ms, render;
+        __disable_irq();
+        ms = Sched_NextDeadline(&s_input);
+        render = Sched_NextDeadline(&s_render);
+        if (render < ms) {
+            ms = render;
+        }
+        if (ms <= 1) {
+            __WFI();
+        } else {
+            uint64_t t0 = s_now_us;
+            uint32_t tick0 = HAL_GetTick();
+            uint64_t dt, dtick;
+
+            Tickless_Sleep(ms);
+            _after_restore();
+            r->sleeps++;
+
+            // 挂起的节拍中断还会推进 1ms，与真实经过时间比较时一并计入
+            dt = s_now_us - t0;
+            dtick = (uint64_t)(HAL_GetTick() - tick0 + ((TIM17->SR & TIM_SR_UIF) != 0)) * 1000u;
+            if ((dtick > dt ? dtick - dt : dt - dtick) > r->worst_error_us) {
+                r->worst_error_us = (uint32_t)(dtick > dt ? dtick - dt : dt - dtick);
+            }
+        }
+        __enable_irq();
+        r->wakeups++;
+
+        s_exti_pending = 0;
+        if (TIM17->SR & TIM_SR_UIF) {
+            TIM17->SR &= ~TIM_SR_UIF;
+            _tick_isr();
+        }
+    }
+    stub_wfi_hook = 0;
+}
+
+int main(void)
+{
+    Run_t quiet, pressed;
+    uint32_t polling = (uint32_t)(HOUR_US / 1000u);
+
+    // CubeMX 中 TIM17 的 1ms 节拍配置: 48MHz / 480 / 100
+    s_htim17.Instance = TIM17;
+    s_htim17.Init.Prescaler = 479;
+    s_htim17.Init.Period = 99;
+    Tickless_Init(&s_htim17, 1);
+
+    // 只有周期定时器: 每次都是定时到期唤醒，HAL tick 必须与真实时间完全一致
+    _run_hour(&quiet, 0, 0);
+    CHECK(s_dump_count == HOUR_US / 1000u / DUMP_PERIOD_MS);
+    CHECK(s_dump_late == 0);
+    CHECK(quiet.worst_error_us == 0);
+    CHECK((uint64_t)HAL_GetTick() * 1000u == s_now_us);
+
+    // 每 37.3337s 一次按键边沿 (不在毫秒边界上): 提前唤醒时不足 1ms 的部分由随后的节拍补上，
+    // 单次误差小于 1ms，一小时后 HAL tick 也不落后于真实时间 1ms 以上
+    _run_hour(&pressed, 37333700u, 1234567u);
+    CHECK(pressed.worst_error_us < 1000u);
+    CHECK((uint64_t)HAL_GetTick() * 1000u <= s_now_us && s_now_us - (uint64_t)HAL_GetTick() * 1000u < 1000u);
+    CHECK(s_dump_count >= HOUR_US / 1000u / DUMP_PERIOD_MS - 1);
+
+    printf("wakeups/hour: 1ms polling %u, tickless %u (%u sleeps), tickless + button edges %u\n",
+           (unsigned)polling, (unsigned)quiet.wakeups, (unsigned)quiet.sleeps, (unsigned)pressed.wakeups);
+    // 每次都睡满到截止时刻或单次上限 (16位 ARR 按 10us 计数约 655ms)，每个输出周期只醒来 ceil(10s / 655ms) 次
+    CHECK(quiet.wakeups <= (DUMP_PERIOD_MS + TICKLESS_MAX_MS - 1) / TICKLESS_MAX_MS * (HOUR_US / 1000u / DUMP_PERIOD_MS));
+
+    printf("test_tickless: %s\n", s_failed ? "FAILED" : "ok");
+    return s_failed != 0;
+}
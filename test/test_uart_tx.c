@@ -0,0 +1,219 @@
+/* === C代码文件: test_uart_tx.c === */
+// uart_tx.c 的主机测试: 用内存模拟 DMA1 通道2，检查各溢出策略下输出的字节序列，
+// 以及正在 DMA 发送的一段在传输完成前从不被改写
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../user/uart_tx.c"
+
+uint8_t Kernel_CurrentPriority(void) { return 0; }
+
+static int s_failed;
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); s_failed++; } } while (0)
+
+#define IO_MAX  (1u << 22)
+static uint8_t s_in[IO_MAX], s_out[IO_MAX];
+static uint32_t s_in_len, s_out_len;
+
+// 模拟 DMA 启动时的内容快照，传输完成时与缓冲区比较
+static uint8_t s_snap[UART_TX_BUF_SIZE];
+static uint8_t s_snap_valid;
+static uint32_t s_corrupted;
+
+static uint8_t *_dma_src(void)
+{
+    return &s_buf[(uint32_t)(DMA1_Channel2->CMAR - (uint32_t)(uintptr_t)s_buf)];
+}
+
+static void _snapshot(void)
+{
+    if ((DMA1_Channel2->CCR & DMA_CCR_EN) && !s_snap_valid) {
+        memcpy(s_snap, _dma_src(), DMA1_Channel2->CNDTR);
+        s_snap_valid = 1;
+    }
+}
+
+// DMA 把当前一段发完并进入传输完成中断
+static void _dma_complete(void)
+{
+    uint32_t n = DMA1_Channel2->CNDTR;
+
+    if (!(DMA1_Channel2->CCR & DMA_CCR_EN)) {
+        return;
+    }
+    if (memcmp(s_snap, _dma_src(), n)) {
+        s_corrupted++;
+    }
+    memcpy(&s_out[s_out_len], _dma_src(), n);
+    s_out_len += n;
+    s_snap_valid = 0;
+    DMA1->ISR |= DMA_ISR_TCIF2;
+    UartTx_DMA_IRQHandler();
+    DMA1->ISR = 0;
+    _snapshot();
+}
+
+static uint16_t _send(const uint8_t *data, uint16_t len, UartTx_Policy_t policy)
+{
+    uint16_t n;
+
+    memcpy(&s_in[s_in_len], data, len);
+    s_in_len += len;
+    n = UartTx_Send(data, len, policy);
+    _snapshot();
+    return n;
+}
+
+static void _reset(void)
+{
+    memset(DMA1_Channel2, 0, sizeof(*DMA1_Channel2));
+    UartTx_Init();
+    s_in_len = s_out_len = 0;
+    s_snap_valid = 0;
+    s_corrupted = 0;
+}
+
+// 输出须是输入按顺序的子序列 (输入为递增计数，丢弃只会跳过字节)
+static int _is_subsequence(void)
+{
+    uint32_t i, j = 0;
+
+    for (i = 0; i < s_out_len; i++) {
+        while (j < s_in_len && s_in[j] != s_out[i]) {
+            j++;
+        }
+        if (j == s_in_len) {
+            return 0;
+        }
+        j++;
+    }
+    return 1;
+}
+
+static void test_random(UartTx_Policy_t policy)
+{
+    uint8_t seq = 0, buf[300];
+    const UartTx_Stats_t *st;
+    int it, i;
+
+    _reset();
+    srand(policy + 1);
+    for (it = 0; it < 10000; it++) {
+        int n = rand() % 300;
+        for (i = 0; i < n; i++) {
+            buf[i] = seq++;
+        }
+        _send(buf, (uint16_t)n, policy);
+        if (rand() % 3 == 0) {
+            _dma_complete();
+        }
+    }
+    while (DMA1_Channel2->CCR & DMA_CCR_EN) {
+        _dma_complete();
+    }
+
+    st = UartTx_Stats();
+    CHECK(s_corrupted == 0);
+    CHECK(_is_subsequence());
+    CHECK(s_out_len + st->dropped == s_in_len);
+    if (policy == UART_TX_DROP) {
+        CHECK(st->written == s_out_len);
+    }
+    CHECK(st->peak <= UART_TX_BUF_SIZE);
+    if (policy == UART_TX_OVERWRITE) {
+        CHECK(s_out[s_out_len - 1] == s_in[s_in_len - 1]);
+    }
+}
+
+// 缓冲区满、DMA 正在发送 [0, 32) 时按覆盖策略写入: 只能丢弃等待中的数据，不能占用正在发送的一段
+static void test_overwrite_keeps_inflight(void)
+{
+    uint8_t fill[UART_TX_BUF_SIZE], more[UART_TX_CHUNK], before[UART_TX_CHUNK];
+    const UartTx_Stats_t *st;
+    uint16_t i;
+
+    _reset();
+    for (i = 0; i < sizeof(fill); i++) {
+        fill[i] = (uint8_t)i;
+    }
+    memset(more, 0xEE, sizeof(more));
+
+    _send(fill, UART_TX_CHUNK, UART_TX_DROP);        // DMA 开始发送 [0, 32)
+    CHECK(DMA1_Channel2->CNDTR == UART_TX_CHUNK);
+    _send(fill + UART_TX_CHUNK, UART_TX_BUF_SIZE - UART_TX_CHUNK, UART_TX_DROP);
+    CHECK(s_head - s_dma == UART_TX_BUF_SIZE);
+
+    memcpy(before, s_buf, UART_TX_CHUNK);
+    CHECK(_send(more, sizeof(more), UART_TX_OVERWRITE) == sizeof(more));
+    CHECK(memcmp(before, s_buf, UART_TX_CHUNK) == 0);
+
+    st = UartTx_Stats();
+    CHECK(st->dropped == UART_TX_BUF_SIZE - UART_TX_CHUNK);
+    while (DMA1_Channel2->CCR & DMA_CCR_EN) {
+        _dma_complete();
+    }
+    CHECK(s_corrupted == 0);
+    CHECK(s_out_len == UART_TX_CHUNK + sizeof(more));
+    CHECK(memcmp(s_out, fill, UART_TX_CHUNK) == 0);
+    CHECK(memcmp(s_out + UART_TX_CHUNK, more, sizeof(more)) == 0);
+}
+
+// 一次写入比缓冲区剩余空间还长: 只保留能放在正在发送的一段之后的最新数据
+static void test_overwrite_longer_than_space(void)
+{
+    uint8_t first[UART_TX_CHUNK], big[UART_TX_BUF_SIZE * 2];
+    uint16_t i;
+
+    _reset();
+    memset(first, 0x11, sizeof(first));
+    for (i = 0; i < sizeof(big); i++) {
+        big[i] = (uint8_t)(i * 7);
+    }
+    _send(first, sizeof(first), UART_TX_DROP);
+    _send(big, sizeof(big), UART_TX_OVERWRITE);
+    while (DMA1_Channel2->CCR & DMA_CCR_EN) {
+        _dma_complete();
+    }
+    CHECK(s_corrupted == 0);
+    CHECK(s_out_len == UART_TX_BUF_SIZE);
+    CHECK(memcmp(s_out, first, sizeof(first)) == 0);
+    CHECK(memcmp(s_out + sizeof(first), big + sizeof(big) - (UART_TX_BUF_SIZE - sizeof(first)),
+                 UART_TX_BUF_SIZE - sizeof(first)) == 0);
+}
+
+// _write (printf 的底层) 按当前策略进入同一缓冲区，总是报告全部写入
+static void test_write_syscall(void)
+{
+    static const char msg[] = "hello\r\n";
+
+    _reset();
+    CHECK(_write(1, (char *)msg, (int)strlen(msg)) == (int)strlen(msg));
+    while (DMA1_Channel2->CCR & DMA_CCR_EN) {
+        _dma_complete();
+    }
+    CHECK(s_out_len == strlen(msg));
+    CHECK(memcmp(s_out, msg, strlen(msg)) == 0);
+}
+
+// 环形缓冲区来自内存池的大块等级，重复初始化不会再申请
+static void test_buffer_from_pool(void)
+{
+    CHECK(s_buf != 0);
+    CHECK(Mem_Pool(MEMPOOL_LARGE)->used == 1);
+    _reset();
+    CHECK(Mem_Pool(MEMPOOL_LARGE)->used == 1);
+}
+
+int main(void)
+{
+    Mem_Init();
+    _reset();
+    test_buffer_from_pool();
+    test_random(UART_TX_DROP);
+    test_random(UART_TX_OVERWRITE);
+    test_overwrite_keeps_inflight();
+    test_overwrite_longer_than_space();
+    test_write_syscall();
+    printf("test_uart_tx: %s\n", s_failed ? "FAILED" : "ok");
+    return s_failed != 0;
+}
@@ -0,0 +1,149 @@
+/* === C代码文件: test_ws2812.c === */
+// ws2812.c 的主机测试: 半字节查表编码的位序列，以及半缓冲区中断按顺序送出整帧数据
+#include <stdio.h>
+#include <string.h>
+#include "../user/ws2812.c"
+
+static int s_failed;
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); s_failed++; } } while (0)
+
+// 逐位编码作为参考: 高位先发，0 -> 1000，1 -> 1100
+static uint32_t _reference_code(uint8_t value)
+{
+    uint32_t code = 0;
+    int bit;
+
+    for (bit = 7; bit >= 0; bit--) {
+        code = (code << 4) | ((value >> bit) & 1u ? 0xCu : 0x8u);
+    }
+    return code;
+}
+
+static void test_encode_pattern(void)
+{
+    static const uint8_t src[] = { 0xA5 };
+    static const uint8_t expect[] = { 0xC8, 0xC8, 0x8C, 0x8C };
+    uint8_t dst[4];
+
+    WS2812_Encode(src, 1, dst);
+    CHECK(memcmp(dst, expect, sizeof(expect)) == 0);
+}
+
+static void test_encode_all_values(void)
+{
+    uint8_t src[256], dst[256 * WS2812_SPI_BYTES_PER_BYTE];
+    int v;
+
+    for (v = 0; v < 256; v++) {
+        src[v] = (uint8_t)v;
+    }
+    WS2812_Encode(src, 256, dst);
+    for (v = 0; v < 256; v++) {
+        const uint8_t *p = &dst[v * WS2812_SPI_BYTES_PER_BYTE];
+        uint32_t got = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        if (got != _reference_code((uint8_t)v)) {
+            printf("0x%02X -> %08X, expected %08X\n", v, (unsigned)got, (unsigned)_reference_code((uint8_t)v));
+            s_failed++;
+        }
+    }
+}
+
+// --- 整帧发送 ---
+
+#define PIXELS  7   // 不是 WS2812_CHUNK_PIXELS 的整数倍，最后一段需要补低电平
+
+static uint8_t s_wire[4096];
+static uint32_t s_wire_len;
+
+// 记录 DMA 已经送出的一半 (中断里会被改写，须在调用中断处理之前取走)
+static void _shift_out(uint32_t half)
+{
+    memcpy(&s_wire[s_wire_len], s_dma_buf[half], WS2812_HALF_BYTES);
+    s_wire_len += WS2812_HALF_BYTES;
+}
+
+// IFCR 写1清零: CGIF3 清除通道3的全部标志
+static void _irq(void)
+{
+    uint32_t clear;
+
+    DMA1->IFCR = 0;
+    WS2812_DMA_IRQHandler();
+    clear = DMA1->IFCR;
+    if (clear & DMA_IFCR_CGIF3) {
+        clear |= DMA_ISR_TCIF3 | DMA_ISR_HTIF3 | 0x800u;
+    }
+    DMA1->ISR &= ~clear;
+}
+
+static void _run_frame(uint8_t late_irq)
+{
+    uint32_t guard = 0;
+
+    while ((DMA1_Channel3->CCR & DMA_CCR_EN) && guard++ < 100) {
+        if (late_irq) {
+            // 中断被耽搁: 两半都已发完，两个标志同时置位
+            _shift_out(0);
+            _shift_out(1);
+            DMA1->ISR |= DMA_ISR_HTIF3 | DMA_ISR_TCIF3;
+            _irq();
+            if (DMA1->ISR & (DMA_ISR_HTIF3 | DMA_ISR_TCIF3)) {
+                _irq();
+            }
+        } else {
+            _shift_out(0);
+            DMA1->ISR |= DMA_ISR_HTIF3;
+            _irq();
+            if (!(DMA1_Channel3->CCR & DMA_CCR_EN)) {
+                break;
+            }
+            _shift_out(1);
+            DMA1->ISR |= DMA_ISR_TCIF3;
+            _irq();
+        }
+    }
+}
+
+static void test_frame(uint8_t late_irq)
+{
+    uint8_t grb[PIXELS * WS2812_BYTES_PER_PIXEL], expect[sizeof(grb) * WS2812_SPI_BYTES_PER_BYTE];
+    uint16_t i;
+    uint32_t k;
+
+    DMA1->ISR = 0;
+    WS2812_Init(PIXELS);
+    _run_frame(0);  // 上电时的全灭帧
+
+    for (i = 0; i < PIXELS; i++) {
+        WS2812_SetPixel(i, (uint8_t)(i * 30 + 1), (uint8_t)(0xA5 ^ i), (uint8_t)(255 - i));
+        grb[i * 3 + 0] = (uint8_t)(0xA5 ^ i);
+        grb[i * 3 + 1] = (uint8_t)(i * 30 + 1);
+        grb[i * 3 + 2] = (uint8_t)(255 - i);
+    }
+    WS2812_Encode(grb, sizeof(grb), expect);
+
+    s_wire_len = 0;
+    WS2812_Show();
+    _run_frame(late_irq);
+    CHECK(!WS2812_IsBusy());
+    CHECK(s_wire_len >= sizeof(expect));
+    CHECK(memcmp(s_wire, expect, sizeof(expect)) == 0);
+    // 像素之后全部为复位低电平，至少 WS2812_RESET_CHUNKS 段
+    for (k = sizeof(expect); k < s_wire_len; k++) {
+        if (s_wire[k]) {
+            break;
+        }
+    }
+    CHECK(k == s_wire_len);
+    CHECK(s_wire_len - sizeof(expect) >= (uint32_t)WS2812_RESET_CHUNKS * WS2812_HALF_BYTES);
+}
+
+int main(void)
+{
+    test_encode_pattern();
+    test_encode_all_values();
+    test_frame(0);
+    test_frame(1);
+    printf("test_ws2812: %s\n", s_failed ? "FAILED" : "ok");
+    return s_failed != 0;
+}
@@ -0,0 +1,29 @@
+#!/usr/bin/env python3
+"""生成 user/cie_table.c: 8位亮度 -> CIE 1931 明度校正后的线性占空比 (Q16)。
+
+用法: python3 tools/gen_cie_table.py > user/cie_table.c
+"""
+
+
+def cie_luminance(level):
+    lightness = level * 100.0 / 255.0
+    if lightness <= 8.0:
+        return lightness / 903.3
+    return ((lightness + 16.0) / 116.0) ** 3
+
+
+def main():
+    values = [round(cie_luminance(i) * 65535) for i in range(256)]
+    print("/* === C代码文件: cie_table.c (由 tools/gen_cie_table.py 生成，请勿手改) === */")
+    print('#include "cie_table.h"')
+    print()
+    print("// CIE 明度曲线: 感知亮度 0~255 -> 占空比 0~65535 (Q16)")
+    print("const uint16_t cie_q16[256] = {")
+    for i in range(0, len(values), 8):
+        row = ", ".join("%5d" % v for v in values[i:i + 8])
+        print("    %s," % row)
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
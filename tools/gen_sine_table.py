@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+"""生成 user/sine_table.c: Q15 四分之一周期正弦表 (呼吸灯使用)。
+
+用法: python3 tools/gen_sine_table.py > user/sine_table.c
+"""
+import math
+
+QUARTER = 64  # 每个象限的分段数，需与 sine_table.h 中 SINE_QUARTER_STEPS 一致
+
+
+def main():
+    values = [round(math.sin(math.pi / 2 * i / QUARTER) * 32767) for i in range(QUARTER + 1)]
+    print("/* === C代码文件: sine_table.c (由 tools/gen_sine_table.py 生成，请勿手改) === */")
+    print('#include "sine_table.h"')
+    print()
+    print("// sin(0 ~ pi/2)，Q15 格式，共 SINE_QUARTER_STEPS + 1 项")
+    print("const int16_t sine_q15_quarter[SINE_QUARTER_STEPS + 1] = {")
+    for i in range(0, len(values), 8):
+        row = ", ".join("%6d" % v for v in values[i:i + 8])
+        print("    %s," % row)
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
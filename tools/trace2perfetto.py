@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""把 user/trace.c 的事件追踪缓冲区转换为 Chrome/Perfetto 的 trace JSON。
+
+输入为以下两种之一:
+  - 调试器导出的二进制: (gdb) dump binary value trace.bin trace_buffer
+  - 串口日志: Trace_Dump 输出的 "trace <十六进制>" 行 (日志中有多次输出时取最后一次)
+
+用法: python3 tools/trace2perfetto.py trace.bin > trace.json
+生成的文件在 ui.perfetto.dev 或 chrome://tracing 中打开。
+每次按下/长按到下一次启动 LED 效果的延迟同时输出到 stderr。
+"""
+import json
+import re
+import struct
+import sys
+
+TRACE_MAGIC = 0x45435254
+HEADER = struct.Struct("<IIHH")  # magic, head, depth, sub_per_ms
+RECORD = struct.Struct("<IBBH")  # tick, sub, id, arg
+
+# 与 user/trace.h 中的 Trace_Id_t 保持一致
+TRACE_EXTI = 0x01
+TRACE_MONITOR = 0x02
+TRACE_LED_START = 0x03
+TRACE_BUTTON_EVENT = 0x10
+TRACE_BUTTON_CALLBACK = 0x20
+TRACE_BUTTON_RETURN = 0x2F
+
+# 与 user/button.h 中的 Button_Event_t 保持一致
+BUTTON_EVENTS = ["press", "release", "short_press", "long_press", "long_press_release", "inactive"]
+# 与 user/rgb_led.h 中的 LED_Mode_t 保持一致
+LED_MODES = ["off", "static", "breath", "flash", "program", "fade"]
+
+# Perfetto 中每类事件一条轨道
+TRACKS = {1: "EXTI", 2: "Button", 3: "Callback", 4: "LED"}
+
+LINE_RE = re.compile(r"^trace ([0-9a-fA-F]+)\s*$")
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) >= 4 and struct.unpack_from("<I", data)[0] == TRACE_MAGIC:
+        return data
+
+    # 文本日志: 连续的 trace 行为一次输出
+    dumps, current = [], None
+    for line in data.decode("ascii", "replace").splitlines():
+        m = LINE_RE.match(line.strip())
+        if m:
+            if current is None:
+                current = bytearray()
+            current += bytes.fromhex(m.group(1))
+        elif current is not None:
+            dumps.append(bytes(current))
+            current = None
+    if current is not None:
+        dumps.append(bytes(current))
+    for dump in reversed(dumps):
+        if len(dump) >= HEADER.size and HEADER.unpack_from(dump)[0] == TRACE_MAGIC:
+            return dump
+    sys.exit("%s: no trace buffer found" % path)
+
+
+def records(data):
+    magic, head, depth, sub_per_ms = HEADER.unpack_from(data)
+    if len(data) < HEADER.size + depth * RECORD.size:
+        sys.exit("truncated trace buffer: %d bytes, depth %d" % (len(data), depth))
+    # 未写满时从 0 开始；写满后 head 处为最旧的一条
+    count = min(head, depth)
+    first = head - count
+    for n in range(first, head):
+        tick, sub, rid, arg = RECORD.unpack_from(data, HEADER.size + (n % depth) * RECORD.size)
+        yield tick * 1000.0 + sub * 1000.0 / sub_per_ms, rid, arg
+    if head > depth:
+        sys.stderr.write("note: %d older records were overwritten\n" % (head - depth))
+
+
+def pin_name(mask):
+    return "pin%d" % (mask.bit_length() - 1) if mask else "pin?"
+
+
+def name_of(table, index):
+    return table[index] if index < len(table) else "#%d" % index
+
+
+def convert(recs):
+    events = [{"ph": "M", "pid": 1, "tid": tid, "name": "thread_name", "args": {"name": name}}
+              for tid, name in TRACKS.items()]
+    pending_press = None
+    latencies = []
+
+    for ts, rid, arg in recs:
+        base = {"pid": 1, "ts": ts}
+        if rid == TRACE_EXTI:
+            events.append(dict(base, ph="i", s="t", tid=1, name="EXTI " + pin_name(arg)))
+        elif rid == TRACE_MONITOR:
+            events.append(dict(base, ph="C", name="MO", args={"level": arg}))
+        elif rid == TRACE_LED_START:
+            mode = name_of(LED_MODES, arg)
+            events.append(dict(base, ph="i", s="t", tid=4, name="LED " + mode))
+            if pending_press is not None:
+                latencies.append((pending_press[0], pending_press[1], mode, ts - pending_press[0]))
+                pending_press = None
+        elif TRACE_BUTTON_EVENT <= rid < TRACE_BUTTON_EVENT + len(BUTTON_EVENTS):
+            kind = BUTTON_EVENTS[rid - TRACE_BUTTON_EVENT]
+            label = "%s %s" % (pin_name(arg), kind)
+            events.append(dict(base, ph="i", s="t", tid=2, name=label))
+            if kind in ("press", "long_press"):
+                pending_press = (ts, label)
+        elif TRACE_BUTTON_CALLBACK <= rid < TRACE_BUTTON_CALLBACK + len(BUTTON_EVENTS):
+            kind = BUTTON_EVENTS[rid - TRACE_BUTTON_CALLBACK]
+            events.append(dict(base, ph="B", tid=3, name="on_%s %s" % (kind, pin_name(arg))))
+        elif rid == TRACE_BUTTON_RETURN:
+            events.append(dict(base, ph="E", tid=3))
+        else:
+            events.append(dict(base, ph="i", s="t", tid=1, name="id 0x%02x" % rid, args={"arg": arg}))
+
+    for ts, label, mode, delay in latencies:
+        sys.stderr.write("%10.3f ms  %-22s -> LED %-8s %8.3f ms\n" % (ts / 1000.0, label, mode, delay / 1000.0))
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s <trace.bin | uart.log>" % sys.argv[0])
+    json.dump(convert(records(load(sys.argv[1]))), sys.stdout, indent=1)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
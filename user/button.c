@@ -1,141 +1,328 @@
 /* === C代码文件: button.c (已添加按下/抬起回调) === */
 #include "button.h"
+#include "event_queue.h"
+#include "profiler.h"
+#include "trace.h"
 
-#define LONG_PRESS_TIME    500  // 长按阈值 (ms)
-#define DEBOUNCE_TIME       50  // 消抖时间 (ms)
+// 状态结构体必须保持紧凑，描述符表才有意义
+_Static_assert(sizeof(Button_t) <= 6, "Button_t should stay a few bytes");
 
-void Button_Init(Button_t *btn, GPIO_TypeDef *port, uint16_t pin)
-{
-    btn->port = port;
-    btn->pin = pin;
-    btn->last_level = 1; // 假设默认是高电平（松开状态）
-    btn->press_time = 0;
-    btn->long_press_triggered = 0;
-
-    // 回调函数指针初始化
-    btn->on_press = 0;               // 新增
-    btn->on_release = 0;             // 新增
-    btn->on_short_press = 0;
-    btn->on_long_press = 0;
-    btn->on_long_press_release = 0;
-    btn->on_inactive = 0;
-
-    // 无活动检测成员初始化
-    btn->inactive_time = 0;
-    btn->inactive_timer = 0;
-    btn->inactive_triggered = 0;
-}
-
-// 新增：设置按下回调函数
-void Button_SetPressCallback(Button_t *btn, void (*callback)(void))
-{
-    btn->on_press = callback;
-}
+// 扫描中断 -> 主循环 的事件队列 (静态清零即为空队列)
+static EventQueue_t s_button_events;
 
-// 新增：设置抬起回调函数
-void Button_SetReleaseCallback(Button_t *btn, void (*callback)(void))
+static void (*_button_callback(const Button_Config_t *cfg, uint8_t type))(void)
 {
-    btn->on_release = callback;
+    switch (type) {
+        case BUTTON_EVENT_PRESS:              return cfg->on_press;
+        case BUTTON_EVENT_RELEASE:            return cfg->on_release;
+        case BUTTON_EVENT_SHORT_PRESS:        return cfg->on_short_press;
+        case BUTTON_EVENT_LONG_PRESS:         return cfg->on_long_press;
+        case BUTTON_EVENT_LONG_PRESS_RELEASE: return cfg->on_long_press_release;
+        case BUTTON_EVENT_INACTIVE:           return cfg->on_inactive;
+        default:                              return 0;
+    }
 }
 
-void Button_SetShortPressCallback(Button_t *btn, void (*callback)(void))
+// 只为设置了回调的事件入队，中断中不执行任何用户代码
+static void _button_emit(const Button_Config_t *cfg, Button_Event_t type)
 {
-    btn->on_short_press = callback;
+    TRACE(TRACE_BUTTON_EVENT + type, cfg->pin);
+    if (_button_callback(cfg, type)) {
+        EventQueue_Push(&s_button_events, cfg, (uint8_t)type);
+    }
 }
 
-void Button_SetLongPressCallback(Button_t *btn, void (*callback)(void))
+void Button_Init(Button_t *btn)
 {
-    btn->on_long_press = callback;
-}
+    uint16_t now = (uint16_t)HAL_GetTick();
 
-void Button_SetLongPressReleaseCallback(Button_t *btn, void (*callback)(void))
-{
-    btn->on_long_press_release = callback;
-}
+    btn->last_level = 1; // 假设默认是高电平（松开状态）
+    btn->press_start = now;
+    btn->long_press_triggered = 0;
 
-void Button_SetInactiveCallback(Button_t *btn, void (*callback)(void), uint32_t time)
-{
-    btn->on_inactive = callback;
-    btn->inactive_time = time;
+    // 无活动计时从初始化时刻开始
+    btn->inactive_start = now;
+    btn->inactive_triggered = 0;
 }
 
-// 此函数应放在一个定时器中断中，例如每 1ms 调用一次
-void Button_Scan(Button_t *btn)
+// 按键状态机，current_level 为本次采样 (或消抖后) 的电平，now 为采样时刻
+// 时间用16位无符号差值 (now - start) 比较，阈值不超过 65535ms 时回绕依然正确
+static void _button_process(const Button_Config_t *cfg, Button_t *btn,
+                            uint8_t current_level, uint16_t now)
 {
-    // 假设按键按下为低电平，松开为高电平
-    uint8_t current_level = HAL_GPIO_ReadPin(btn->port, btn->pin);
-
     // --- 1. 按键按下期间的逻辑 ---
-    if (current_level == GPIO_PIN_RESET) 
+    if (current_level == GPIO_PIN_RESET)
     {
-        // 任何按键活动都会重置无活动计时器
-        btn->inactive_timer = 0;
-        btn->inactive_triggered = 0;
-
         // 刚按下的瞬间 (下降沿)
         if (btn->last_level == GPIO_PIN_SET) {
-            // --- 新增: 触发按下回调 ---
-            if (btn->on_press) {
-                btn->on_press();
-            }
-            btn->press_time = 0;
+            _button_emit(cfg, BUTTON_EVENT_PRESS);
+            btn->press_start = now;
             btn->long_press_triggered = 0;
-        } 
-        // 持续按住
-        else { 
-            btn->press_time += 1; // 假设每 1ms 调用一次
-            
-            // 检查是否达到长按时间，且长按事件尚未触发
-            if (btn->press_time >= LONG_PRESS_TIME && !btn->long_press_triggered) {
-                if (btn->on_long_press) {
-                    btn->on_long_press();
-                }
-                btn->long_press_triggered = 1; // 标记已触发，防止重复调用
-            }
+            // 任何按键活动都会重置无活动计时
+            btn->inactive_triggered = 0;
+        }
+        // 持续按住: 检查是否达到长按时间，且长按事件尚未触发
+        else if (!btn->long_press_triggered &&
+                 (uint16_t)(now - btn->press_start) >= cfg->long_press_time) {
+            _button_emit(cfg, BUTTON_EVENT_LONG_PRESS);
+            btn->long_press_triggered = 1; // 标记已触发，防止重复调用
         }
     }
     // --- 2. 按键松开期间的逻辑 ---
-    else 
+    else
     {
         // 刚松开的瞬间 (上升沿)
         if (btn->last_level == GPIO_PIN_RESET) {
-            // --- 新增: 触发抬起回调 ---
-            if (btn->on_release) {
-                btn->on_release();
-            }
-            
-            // 任何按键活动都会重置无活动计时器
-            btn->inactive_timer = 0;
+            _button_emit(cfg, BUTTON_EVENT_RELEASE);
+
+            // 无活动计时从松开时刻开始
+            btn->inactive_start = now;
             btn->inactive_triggered = 0;
 
             // 判断是哪种事件
             if (btn->long_press_triggered) {
                 // 如果长按已触发，则这次是“长按后抬起”
-                if (btn->on_long_press_release) {
-                    btn->on_long_press_release();
-                }
-            } else if (btn->press_time >= DEBOUNCE_TIME) {
+                _button_emit(cfg, BUTTON_EVENT_LONG_PRESS_RELEASE);
+            } else if ((uint16_t)(now - btn->press_start) >= cfg->debounce_time) {
                 // 如果长按未触发，且时间超过消抖时间，则是“短按”
-                if (btn->on_short_press) {
-                    btn->on_short_press();
-                }
+                _button_emit(cfg, BUTTON_EVENT_SHORT_PRESS);
             }
-            // 时间小于 DEBOUNCE_TIME 的抖动将被忽略
+            // 时间小于 debounce_time 的抖动将被忽略
 
             // 重置状态
-            btn->press_time = 0;
             btn->long_press_triggered = 0;
         }
 
         // --- 3. 无活动判断逻辑 (仅在按键松开时计时) ---
-        if (btn->on_inactive && btn->inactive_time > 0 && !btn->inactive_triggered) {
-            btn->inactive_timer += 1; // 累加无活动时间
-            if (btn->inactive_timer >= btn->inactive_time) {
-                btn->on_inactive();
-                btn->inactive_triggered = 1; // 标记为已触发，防止重复调用
-            }
+        if (cfg->on_inactive && cfg->inactive_time > 0 && !btn->inactive_triggered &&
+            (uint16_t)(now - btn->inactive_start) >= cfg->inactive_time) {
+            _button_emit(cfg, BUTTON_EVENT_INACTIVE);
+            btn->inactive_triggered = 1; // 标记为已触发，防止重复调用
         }
     }
 
     btn->last_level = current_level;
 }
+
+// 此函数应放在一个定时器中断或调度任务中周期调用，调用间隔不必固定
+void Button_Scan(const Button_Config_t *cfg, Button_t *btn)
+{
+    // 假设按键按下为低电平，松开为高电平
+    _button_process(cfg, btn, HAL_GPIO_ReadPin(cfg->port, cfg->pin), (uint16_t)HAL_GetTick());
+}
+
+// 判断按键是否还需要逐 tick 处理 (长按计时或无活动计时)
+static uint8_t _button_is_busy(const Button_Config_t *cfg, const Button_t *btn)
+{
+    if (btn->last_level == GPIO_PIN_RESET) {
+        return !btn->long_press_triggered;
+    }
+    return cfg->on_inactive && cfg->inactive_time > 0 && !btn->inactive_triggered;
+}
+
+// 对 work 中的按键执行状态机并更新 busy_mask；描述符表按引脚升序排列，
+// 每经过一个已注册引脚表下标加1
+static void _port_process(ButtonPort_t *bp, uint16_t work, uint16_t now)
+{
+    uint16_t pins = bp->pin_mask;
+    uint8_t idx;
+
+    for (idx = 0; work; work >>= 1, pins >>= 1) {
+        if (!(pins & 1u)) {
+            continue;
+        }
+        if (work & 1u) {
+            const Button_Config_t *cfg = &bp->cfg[idx];
+            Button_t *btn = &bp->state[idx];
+
+            _button_process(cfg, btn, (bp->level & cfg->pin) ? GPIO_PIN_SET : GPIO_PIN_RESET, now);
+            if (_button_is_busy(cfg, btn)) {
+                bp->busy_mask |= cfg->pin;
+            } else {
+                bp->busy_mask &= (uint16_t)~cfg->pin;
+            }
+        }
+        idx++;
+    }
+}
+
+// 把端口定时器设到最早的长按/无活动到期时刻，没有计时则停止
+static void _port_arm(ButtonPort_t *bp)
+{
+    uint32_t next = Button_PortNextDeadline(bp);
+
+    if (next == UINT32_MAX) {
+        SoftTimer_Stop(bp->timer);
+    } else {
+        SoftTimer_Start(bp->timer, next, 0);
+    }
+}
+
+// 计时到期: 只处理计时中的按键
+static void _port_timeout(void *arg)
+{
+    ButtonPort_t *bp = (ButtonPort_t *)arg;
+
+    _port_process(bp, bp->busy_mask, (uint16_t)HAL_GetTick());
+    _port_arm(bp);
+}
+
+uint8_t Button_PortInit(ButtonPort_t *bp, const Button_Config_t *cfg, Button_t *state, uint8_t count)
+{
+    uint8_t i;
+
+    if (count == 0) {
+        return 0;
+    }
+    bp->port = cfg[0].port;
+    bp->cfg = cfg;
+    bp->state = state;
+    bp->pin_mask = 0;
+    bp->level = (uint16_t)bp->port->IDR; // 以当前电平作为初始稳定状态
+    bp->cnt0 = 0;
+    bp->cnt1 = 0;
+    bp->busy_mask = 0;
+
+    for (i = 0; i < count; i++) {
+        // 扫描时按引脚号升序推算表下标，因此要求同端口、单引脚、升序
+        if (cfg[i].port != bp->port || (cfg[i].pin & (cfg[i].pin - 1)) ||
+            cfg[i].pin <= bp->pin_mask) {
+            return 0;
+        }
+        bp->pin_mask |= cfg[i].pin;
+        Button_Init(&state[i]);
+        if (_button_is_busy(&cfg[i], &state[i])) {
+            bp->busy_mask |= cfg[i].pin;
+        }
+    }
+
+    bp->timer = SoftTimer_Create(_port_timeout, bp);
+    if (bp->timer) {
+        _port_arm(bp);
+    }
+    return 1;
+}
+
+uint16_t Button_ScanPort(ButtonPort_t *bp)
+{
+    uint16_t sample = (uint16_t)bp->port->IDR; // 整个端口只读一次
+    uint16_t now = (uint16_t)HAL_GetTick();
+    uint16_t delta, toggle;
+    PROF_ENTER(PROF_BUTTON_SCAN);
+
+    // 垂直计数器: 每个引脚一个2位计数器，电平与稳定状态不同时计数，
+    // 连续4次不同才翻转稳定状态，中途一致则计数器清零
+    delta = sample ^ bp->level;
+    bp->cnt1 = (bp->cnt1 ^ bp->cnt0) & delta;
+    bp->cnt0 = ~bp->cnt0 & delta;
+    toggle = delta & ~(bp->cnt0 | bp->cnt1) & bp->pin_mask;
+    bp->level ^= toggle;
+
+    // 只处理有跳变的按键；没有端口定时器时每次扫描还要检查计时中的按键
+    if (bp->timer) {
+        if (toggle) {
+            _port_process(bp, toggle, now);
+            _port_arm(bp);
+        }
+    } else {
+        _port_process(bp, toggle | bp->busy_mask, now);
+    }
+
+    PROF_EXIT(PROF_BUTTON_SCAN);
+    return toggle;
+}
+
+uint8_t Button_PortIdle(const ButtonPort_t *bp)
+{
+    // 还有引脚在消抖中，或电平已经变化 (下一次扫描就开始消抖)，需要继续扫描；
+    // 按住或计时中的按键不影响空闲，计时由 Button_PortNextDeadline 给出唤醒时刻
+    return !((bp->cnt0 | bp->cnt1) & bp->pin_mask) &&
+           !(((uint16_t)bp->port->IDR ^ bp->level) & bp->pin_mask);
+}
+
+uint8_t Button_PortSleep(ButtonPort_t *bp)
+{
+    if (!Button_PortIdle(bp)) {
+        return 0;
+    }
+    if (Button_PortAsleep(bp)) {
+        return 1; // 已经打开，不再清除挂起的边沿
+    }
+
+    // 先打开 EXTI 再复查电平，避免漏掉两者之间发生的跳变
+    EXTI->PR = bp->pin_mask;
+    EXTI->IMR |= bp->pin_mask;
+    if (((uint16_t)bp->port->IDR ^ bp->level) & bp->pin_mask) {
+        EXTI->IMR &= ~(uint32_t)bp->pin_mask;
+        return 0;
+    }
+    return 1;
+}
+
+uint8_t Button_PortAsleep(const ButtonPort_t *bp)
+{
+    return (EXTI->IMR & bp->pin_mask) != 0;
+}
+
+// 距离 deadline 的剩余毫秒数，已到期返回0
+static uint32_t _remaining(uint16_t start, uint16_t duration, uint16_t now)
+{
+    uint16_t elapsed = (uint16_t)(now - start);
+    return elapsed >= duration ? 0 : (uint32_t)(duration - elapsed);
+}
+
+uint32_t Button_PortNextDeadline(const ButtonPort_t *bp)
+{
+    uint16_t now = (uint16_t)HAL_GetTick();
+    uint16_t busy = bp->busy_mask;
+    uint16_t pins = bp->pin_mask;
+    uint32_t next = UINT32_MAX;
+    uint8_t idx;
+
+    // 只有长按计时和无活动计时需要定时唤醒
+    for (idx = 0; busy; busy >>= 1, pins >>= 1) {
+        if (!(pins & 1u)) {
+            continue;
+        }
+        if (busy & 1u) {
+            const Button_Config_t *cfg = &bp->cfg[idx];
+            const Button_t *btn = &bp->state[idx];
+            uint32_t remain = (btn->last_level == GPIO_PIN_RESET)
+                ? _remaining(btn->press_start, cfg->long_press_time, now)
+                : _remaining(btn->inactive_start, cfg->inactive_time, now);
+            if (remain < next) {
+                next = remain;
+            }
+        }
+        idx++;
+    }
+    return next;
+}
+
+void Button_PortWake(ButtonPort_t *bp)
+{
+    // 扫描期间由垂直计数器负责消抖，屏蔽 EXTI 避免抖动反复进中断
+    EXTI->IMR &= ~(uint32_t)bp->pin_mask;
+}
+
+uint8_t Button_HasEvents(void)
+{
+    return s_button_events.head != s_button_events.tail;
+}
+
+uint8_t Button_DispatchEvents(void)
+{
+    Event_t evt;
+    uint8_t count = 0;
+
+    while (EventQueue_Pop(&s_button_events, &evt)) {
+        void (*callback)(void) = _button_callback((const Button_Config_t *)evt.src, evt.type);
+        if (callback) {
+            TRACE(TRACE_BUTTON_CALLBACK + evt.type, ((const Button_Config_t *)evt.src)->pin);
+            callback();
+            TRACE(TRACE_BUTTON_RETURN, ((const Button_Config_t *)evt.src)->pin);
+        }
+        count++;
+    }
+    return count;
+}
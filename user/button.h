@@ -3,42 +3,106 @@
 #define __BUTTON_H
 
 #include "stm32f0xx_hal.h"
+#include "soft_timer.h"
 #include <stdint.h>
 
-// 按键结构体
+// 按键事件类型 (扫描中断只入队事件，回调在主循环中由 Button_DispatchEvents 执行)
+typedef enum {
+    BUTTON_EVENT_PRESS,
+    BUTTON_EVENT_RELEASE,
+    BUTTON_EVENT_SHORT_PRESS,
+    BUTTON_EVENT_LONG_PRESS,
+    BUTTON_EVENT_LONG_PRESS_RELEASE,
+    BUTTON_EVENT_INACTIVE
+} Button_Event_t;
+
+// 默认时间阈值 (ms)
+#define BUTTON_LONG_PRESS_TIME    500  // 长按阈值
+#define BUTTON_DEBOUNCE_TIME       50  // 短按最短持续时间，更短的按下视为抖动
+
+// 按键描述符: 引脚、阈值和回调等不变配置，定义为 const 表放在 Flash 中
+// 时间阈值为16位 (最大 65535ms)，内部用16位时间戳差值计时
 typedef struct {
     GPIO_TypeDef *port;
     uint16_t pin;
 
-    uint8_t last_level;
-    uint32_t press_time;
-    uint8_t long_press_triggered;
+    uint16_t long_press_time;     // 长按阈值 (ms)
+    uint16_t debounce_time;       // 短按最短持续时间 (ms)
+    uint16_t inactive_time;       // 无活动超时时间 (ms)，0 表示不检测
 
-    // 无活动检测相关成员
-    uint32_t inactive_time;       // 无活动超时时间 (ms)
-    uint32_t inactive_timer;      // 无活动计时器
-    uint8_t  inactive_triggered;  // 无活动回调已触发标志
-
-    // --- 回调函数 ---
-    void (*on_press)(void);              // 新增: 按下回调 (实时，无消抖)
-    void (*on_release)(void);            // 新增: 抬起回调 (实时，无消抖)
+    // --- 回调函数 (不需要的传 0) ---
+    void (*on_press)(void);              // 按下回调
+    void (*on_release)(void);            // 抬起回调
     void (*on_short_press)(void);        // 短按回调
     void (*on_long_press)(void);         // 长按回调
     void (*on_long_press_release)(void); // 长按后抬起回调
     void (*on_inactive)(void);           // 无活动回调
+} Button_Config_t;
+
+// 按键运行状态 (RAM)，每个按键 6 字节
+//
+// 每按键 RAM 对比 (Cortex-M0，含端口扫描结构体，每端口最多16个按键):
+//   按键数 | 拆分前: 60B/按键 + 80B/端口 | 拆分后: 6B/按键 + 24B/端口
+//      2   |            200 B             |            36 B
+//      8   |            560 B             |            72 B
+//     32   |           2080 B (2个端口)   |           240 B (2个端口)
+typedef struct {
+    uint16_t press_start;              // 按下时刻 (HAL_GetTick 低16位)
+    uint16_t inactive_start;           // 最近一次松开时刻 (HAL_GetTick 低16位)
+    uint8_t  last_level           : 1;
+    uint8_t  long_press_triggered : 1;
+    uint8_t  inactive_triggered   : 1; // 无活动回调已触发标志
 } Button_t;
 
-void Button_Init(Button_t *btn, GPIO_TypeDef *port, uint16_t pin);
+// --- 端口级并行扫描 ---
+// 一次读取整个端口的 IDR，用垂直计数器对所有引脚并行消抖 (连续4次采样一致才确认跳变，
+// 即消抖时间为4个扫描周期)，只对发生跳变的按键执行状态机；长按/无活动计时由每端口一个
+// 软件定时器在最早的到期时刻触发，ISR 开销不随按键数量线性增长。
+typedef struct {
+    GPIO_TypeDef *port;
+    const Button_Config_t *cfg; // 描述符表 (同一端口，按引脚号升序)
+    Button_t *state;            // 与描述符表一一对应的状态数组
+    uint16_t pin_mask;   // 已注册按键的引脚掩码
+    uint16_t level;      // 消抖后的电平 (1=高电平/松开)
+    uint16_t cnt0;       // 垂直计数器 bit0
+    uint16_t cnt1;       // 垂直计数器 bit1
+    uint16_t busy_mask;  // 计时中的按键 (按住未到长按 / 无活动计时中)
+    SoftTimer_t timer;   // 计时到期定时器，节点池不足时为0，退化为每次扫描检查 busy_mask
+} ButtonPort_t;
+
+void Button_Init(Button_t *btn);
+
+// 所有计时基于 HAL_GetTick 时间戳差值，扫描周期可为 1~20ms 或不固定，
+// 按键语义不变 (计时精度等于扫描间隔)
+void Button_Scan(const Button_Config_t *cfg, Button_t *btn);
+
+// 绑定描述符表和状态数组并初始化状态，表中按键须位于同一端口且按引脚号升序排列，
+// 成功返回1，表为空或不合法返回0
+// 会从软件定时器节点池分配一个定时器，须先调用 SoftTimer_Init
+uint8_t Button_PortInit(ButtonPort_t *bp, const Button_Config_t *cfg, Button_t *state, uint8_t count);
+
+// 周期调用 (建议 1~10ms)，返回本次消抖后发生跳变的引脚掩码
+// 注意: 端口模式下 on_press/on_release 在连续4次采样确认后才触发
+uint16_t Button_ScanPort(ButtonPort_t *bp);
+
+// --- 边沿唤醒 (EXTI) 混合模式 ---
+// 没有引脚处于消抖过程且电平与稳定状态一致时端口空闲 (Button_PortIdle 只读状态和 IDR，可在查询中调用)，
+// 此时 Button_PortSleep 打开这些引脚的 EXTI 中断并返回1，调用者即可停止扫描，
+// 直到任一引脚边沿或 Button_PortNextDeadline 给出的时刻；
+// EXTI 触发后调用 Button_PortWake 屏蔽 EXTI 并恢复扫描。Button_PortAsleep 返回 EXTI 是否已打开。
+// 引脚须配置为 GPIO_MODE_IT_RISING_FALLING (EXTI 线号与引脚号一致)。
+uint8_t Button_PortIdle(const ButtonPort_t *bp);
+uint8_t Button_PortSleep(ButtonPort_t *bp);
+uint8_t Button_PortAsleep(const ButtonPort_t *bp);
+void Button_PortWake(ButtonPort_t *bp);
+
+// 距离下一个长按/无活动计时到期的毫秒数，没有计时返回 UINT32_MAX
+uint32_t Button_PortNextDeadline(const ButtonPort_t *bp);
 
-// --- 回调设置函数 ---
-void Button_SetPressCallback(Button_t *btn, void (*callback)(void));       // 新增
-void Button_SetReleaseCallback(Button_t *btn, void (*callback)(void));     // 新增
-void Button_SetShortPressCallback(Button_t *btn, void (*callback)(void));
-void Button_SetLongPressCallback(Button_t *btn, void (*callback)(void));
-void Button_SetLongPressReleaseCallback(Button_t *btn, void (*callback)(void));
-void Button_SetInactiveCallback(Button_t *btn, void (*callback)(void), uint32_t time);
+// 是否有尚未执行的按键回调
+uint8_t Button_HasEvents(void);
 
-// 修改: 为了使时间常量(如LONG_PRESS_TIME)准确，此函数应每 1ms 调用一次
-void Button_Scan(Button_t *btn);     // 建议每 1ms 调用一次
+// 在主循环中调用，执行扫描中断入队的按键回调，返回本次处理的事件数
+uint8_t Button_DispatchEvents(void);
 
 #endif
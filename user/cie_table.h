@@ -0,0 +1,10 @@
+/* === C/C++ Header代码文件: cie_table.h === */
+#ifndef __CIE_TABLE_H
+#define __CIE_TABLE_H
+
+#include <stdint.h>
+
+// 感知亮度 (0~255) 到线性占空比 (Q16) 的 CIE 明度校正表，由 tools/gen_cie_table.py 生成，位于 Flash
+extern const uint16_t cie_q16[256];
+
+#endif
@@ -0,0 +1,23 @@
+/* === C/C++ Header代码文件: critical.h === */
+#ifndef __CRITICAL_H
+#define __CRITICAL_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 临界区: 保存 PRIMASK 后关中断，退出时恢复进入前的状态，可以嵌套，也可以在中断中调用。
+// 主循环或可被抢占的内核任务修改与中断共享的状态时使用，避免中断读到一半更新的数据。
+
+static inline uint32_t Critical_Enter(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static inline void Critical_Exit(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+#endif
@@ -0,0 +1,44 @@
+/* === C代码文件: event_queue.c === */
+#include "event_queue.h"
+#include "stm32f0xx_hal.h" // __DMB
+
+#define EVENT_QUEUE_MASK   (EVENT_QUEUE_SIZE - 1)
+
+void EventQueue_Init(EventQueue_t *q)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->dropped = 0;
+}
+
+uint8_t EventQueue_Push(EventQueue_t *q, const void *src, uint8_t type)
+{
+    uint8_t head = q->head;
+
+    // 下标自由递增，差值即为队列中的事件数
+    if ((uint8_t)(head - q->tail) >= EVENT_QUEUE_SIZE) {
+        q->dropped++;
+        return 0;
+    }
+
+    q->buf[head & EVENT_QUEUE_MASK].src = src;
+    q->buf[head & EVENT_QUEUE_MASK].type = type;
+    __DMB(); // 先写完数据再发布 head
+    q->head = (uint8_t)(head + 1);
+    return 1;
+}
+
+uint8_t EventQueue_Pop(EventQueue_t *q, Event_t *evt)
+{
+    uint8_t tail = q->tail;
+
+    if (tail == q->head) {
+        return 0;
+    }
+
+    __DMB(); // 读到 head 之后再读数据
+    *evt = q->buf[tail & EVENT_QUEUE_MASK];
+    __DMB(); // 数据读完再释放槽位
+    q->tail = (uint8_t)(tail + 1);
+    return 1;
+}
@@ -0,0 +1,34 @@
+/* === C/C++ Header代码文件: event_queue.h === */
+#ifndef __EVENT_QUEUE_H
+#define __EVENT_QUEUE_H
+
+#include <stdint.h>
+
+// 单生产者/单消费者无锁事件环形队列
+// 生产者 (如定时器中断) 只写 head，消费者 (主循环) 只写 tail。
+// 下标为单字节，Cortex-M0 上单字节读写天然原子，无需 LDREX/STREX 或关中断。
+
+#define EVENT_QUEUE_SIZE   16   // 队列深度，必须为2的幂且不大于128
+
+// 事件记录
+typedef struct {
+    const void *src; // 事件源 (如按键描述符)
+    uint8_t  type;  // 事件类型
+} Event_t;
+
+typedef struct {
+    Event_t buf[EVENT_QUEUE_SIZE];
+    volatile uint8_t head;     // 写下标 (仅生产者修改)
+    volatile uint8_t tail;     // 读下标 (仅消费者修改)
+    volatile uint8_t dropped;  // 队列满时丢弃的事件数 (仅生产者修改)
+} EventQueue_t;
+
+void EventQueue_Init(EventQueue_t *q);
+
+// 生产者调用，队列满时丢弃事件并返回0
+uint8_t EventQueue_Push(EventQueue_t *q, const void *src, uint8_t type);
+
+// 消费者调用，队列空时返回0
+uint8_t EventQueue_Pop(EventQueue_t *q, Event_t *evt);
+
+#endif
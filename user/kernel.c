@@ -0,0 +1,142 @@
+/* === C代码文件: kernel.c === */
+#include "kernel.h"
+#include "critical.h"
+
+static const Kernel_Task_t *s_tasks;
+static Kernel_TaskState_t *s_state;
+static uint8_t s_count;
+static volatile uint8_t s_ready;    // 就绪位图，bit n 对应优先级 n+1
+static volatile uint8_t s_current;  // 当前运行的优先级，0 为主循环
+
+// 4位数中最高置位的位置加1 (Cortex-M0 没有 CLZ 指令)
+static const uint8_t s_log2[16] = { 0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+
+// 最高的就绪优先级，没有就绪任务返回0
+static inline uint8_t _highest(uint8_t ready)
+{
+    return (ready & 0xF0u) ? (uint8_t)(4 + s_log2[ready >> 4]) : s_log2[ready];
+}
+
+// 关中断调用: 依次运行所有高于当前优先级的就绪任务，任务执行期间开中断，可被更高优先级抢占
+static void _schedule(void)
+{
+    uint8_t saved = s_current;
+    uint8_t p;
+
+    while ((p = _highest(s_ready)) > saved) {
+        const Kernel_Task_t *t = &s_tasks[p - 1];
+        Kernel_TaskState_t *st = &s_state[p - 1];
+        Kernel_Event_t evt = t->queue[st->head];
+
+        if (++st->head >= t->queue_size) {
+            st->head = 0;
+        }
+        if (--st->count == 0) {
+            s_ready &= (uint8_t)~(1u << (p - 1));
+        }
+        s_current = p;
+        __enable_irq();
+        t->handler(t->arg, evt);
+        __disable_irq();
+    }
+    s_current = saved;
+}
+
+// PendSV 伪造的异常帧返回到这里 (线程模式)，运行完就绪任务后用 SVC 回到被抢占处
+__attribute__((used, noreturn)) static void _kernel_thread(void)
+{
+    __disable_irq();
+    _schedule();
+    __enable_irq(); // SVC 不能在关中断时执行
+    __asm volatile ("svc 0");
+    for (;;) {
+    }
+}
+
+void Kernel_Init(const Kernel_Task_t *tasks, Kernel_TaskState_t *state, uint8_t count)
+{
+    uint8_t i;
+
+    s_tasks = tasks;
+    s_state = state;
+    s_count = count > KERNEL_MAX_TASKS ? KERNEL_MAX_TASKS : count;
+    for (i = 0; i < s_count; i++) {
+        state[i].head = 0;
+        state[i].count = 0;
+        state[i].dropped = 0;
+    }
+    s_ready = 0;
+    s_current = 0;
+}
+
+uint8_t Kernel_Post(uint8_t prio, uint8_t sig, uint8_t param)
+{
+    const Kernel_Task_t *t;
+    Kernel_TaskState_t *st;
+    uint32_t primask;
+    uint8_t tail;
+
+    if (prio == 0 || prio > s_count) {
+        return 0;
+    }
+    t = &s_tasks[prio - 1];
+    st = &s_state[prio - 1];
+
+    primask = Critical_Enter();
+    if (st->count >= t->queue_size) {
+        st->dropped++;
+        Critical_Exit(primask);
+        return 0;
+    }
+    tail = (uint8_t)(st->head + st->count);
+    if (tail >= t->queue_size) {
+        tail -= t->queue_size;
+    }
+    t->queue[tail].sig = sig;
+    t->queue[tail].param = param;
+    st->count++;
+    s_ready |= (uint8_t)(1u << (prio - 1));
+    if (prio > s_current) {
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+    Critical_Exit(primask);
+    return 1;
+}
+
+uint8_t Kernel_CurrentPriority(void)
+{
+    return s_current;
+}
+
+// PendSV 只在返回线程模式时执行 (LR = 0xFFFFFFF9)，被抢占的现场已由硬件压在 MSP 上。
+// 在其下方再压一个指向 _kernel_thread 的假异常帧后返回，硬件弹出假帧进入调度函数，
+// 原现场留在栈上，由 SVC_Handler 恢复。
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm volatile (
+        "  sub  sp, #32            \n" // 假帧: r0-r3, r12, lr, pc, xpsr
+        "  ldr  r0, =_kernel_thread\n"
+        "  movs r1, #1             \n"
+        "  bics r0, r1             \n" // 帧中的 PC 不带 Thumb 位
+        "  str  r0, [sp, #24]      \n"
+        "  ldr  r0, =0x01000000    \n" // xPSR: 只置 T 位
+        "  str  r0, [sp, #28]      \n"
+        "  bx   lr                 \n"
+        "  .ltorg                  \n"
+    );
+}
+
+// 丢弃 _kernel_thread 执行 SVC 时压的帧 (含可能的 4 字节对齐填充，由压栈 xPSR 的 bit9 指示)，
+// 再次异常返回即弹出 PendSV 进入时保存的原现场
+__attribute__((naked)) void SVC_Handler(void)
+{
+    __asm volatile (
+        "  ldr  r0, [sp, #28]      \n"
+        "  lsrs r0, r0, #10        \n" // bit9 移入进位标志
+        "  add  sp, #32            \n"
+        "  bcc  1f                 \n"
+        "  add  sp, #4             \n"
+        "1:                        \n"
+        "  bx   lr                 \n"
+    );
+}
@@ -0,0 +1,59 @@
+/* === C/C++ Header代码文件: kernel.h === */
+#ifndef __KERNEL_H
+#define __KERNEL_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 运行至完成 (run-to-completion) 抢占式内核，所有任务共用一个 MSP 栈
+//
+// 任务是事件处理函数，每次处理一个事件后返回，没有各自的栈和上下文。
+// 中断或任务投递事件后，若目标任务优先级高于当前运行的任务，就挂起 PendSV；
+// PendSV (最低优先级) 在栈上伪造一个异常返回帧，"返回" 到线程模式的调度函数，
+// 依次运行所有高于被抢占者的就绪任务，再用 SVC 丢弃自己的帧回到被抢占处。
+// 高优先级任务像嵌套中断一样抢占低优先级任务，栈深度只随优先级数增长，
+// 抢占延迟等于最长的关中断时间加一次 PendSV 进出，与任务执行时长无关。
+//
+// 优先级即任务表下标加1，表中越靠后优先级越高；主循环相当于优先级0。
+// PendSV 须配置为最低优先级 (3)，SVC 须高于 PendSV。
+
+#define KERNEL_MAX_TASKS   8
+
+typedef struct {
+    uint8_t sig;    // 事件信号
+    uint8_t param;  // 信号参数
+} Kernel_Event_t;
+
+// 任务描述符 (const，位于 Flash)
+typedef struct {
+    void (*handler)(void *arg, Kernel_Event_t evt);
+    void *arg;
+    Kernel_Event_t *queue;  // 事件队列缓冲区 (RAM)
+    uint8_t queue_size;     // 事件队列深度
+} Kernel_Task_t;
+
+// 任务运行状态 (RAM)，与任务表一一对应
+typedef struct {
+    uint8_t head;     // 队头下标
+    uint8_t count;    // 队列中的事件数
+    uint8_t dropped;  // 队列满时丢弃的事件数
+} Kernel_TaskState_t;
+
+/**
+ * @brief 绑定任务表，清空所有事件队列
+ * @param count 任务数，不超过 KERNEL_MAX_TASKS
+ */
+void Kernel_Init(const Kernel_Task_t *tasks, Kernel_TaskState_t *state, uint8_t count);
+
+/**
+ * @brief 向任务投递事件，可在中断、任务和主循环中调用
+ * @param prio 目标任务优先级 (任务表下标加1)
+ * @return 1: 成功; 0: 队列已满，事件丢弃
+ * @note  目标优先级高于当前时，在本函数退出临界区后立即被抢占
+ */
+uint8_t Kernel_Post(uint8_t prio, uint8_t sig, uint8_t param);
+
+// 当前运行的任务优先级，主循环中为0
+uint8_t Kernel_CurrentPriority(void);
+
+#endif
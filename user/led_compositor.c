@@ -0,0 +1,189 @@
+/* === C代码文件: led_compositor.c === */
+#include "led_compositor.h"
+#include "critical.h"
+
+// LED_Compositor_Update 在渲染内核任务中执行，会抢占主循环里的按键回调；
+// 回调通过 Show/Hide 修改图层时进入临界区，合成器不会读到一半更新的图层
+
+// 按不透明度混合一个颜色分量，alpha=255 时完全取上层
+static uint8_t _blend(uint8_t below, uint8_t above, uint8_t alpha)
+{
+    uint32_t a = alpha + (alpha >> 7); // 0~256
+    return (uint8_t)((above * a + below * (256 - a)) >> 8);
+}
+
+// 最高的激活图层，没有时返回 -1
+static int8_t _top_layer(const LED_Compositor_t *c)
+{
+    int8_t i;
+
+    for (i = LED_LAYER_COUNT - 1; i >= 0; i--) {
+        if (c->layer[i].active) {
+            break;
+        }
+    }
+    return i;
+}
+
+// 最高图层不透明且为呼吸/闪烁时，输出 LED 直接跟随播放
+static uint8_t _can_follow(const LED_Compositor_t *c, int8_t top)
+{
+    const LED_LayerState_t *l;
+
+    if (top < 0) {
+        return 0;
+    }
+    l = &c->layer[top];
+    return l->alpha == LED_ALPHA_OPAQUE &&
+           (l->effect.mode == LED_MODE_BREATH || l->effect.mode == LED_MODE_FLASH);
+}
+
+void LED_Compositor_Init(LED_Compositor_t *c, RGB_LED_t *out)
+{
+    uint8_t i;
+
+    c->out = out;
+    for (i = 0; i < LED_LAYER_COUNT; i++) {
+        RGB_LED_InitVirtual(&c->layer[i].effect);
+        c->layer[i].active = 0;
+        c->layer[i].alpha = LED_ALPHA_OPAQUE;
+        c->layer[i].expires = 0;
+        c->layer[i].expire_at = 0;
+    }
+    c->dirty = 1;
+}
+
+RGB_LED_t *LED_Compositor_Layer(LED_Compositor_t *c, LED_Layer_t layer)
+{
+    return &c->layer[layer].effect;
+}
+
+void LED_Compositor_Show(LED_Compositor_t *c, LED_Layer_t layer, uint8_t alpha, uint32_t duration_ms)
+{
+    LED_LayerState_t *l = &c->layer[layer];
+    uint32_t primask = Critical_Enter();
+
+    l->alpha = alpha;
+    l->expire_at = HAL_GetTick() + duration_ms;
+    l->expires = duration_ms != 0;
+    l->active = 1;
+    c->dirty = 1;
+    Critical_Exit(primask);
+}
+
+void LED_Compositor_Hide(LED_Compositor_t *c, LED_Layer_t layer)
+{
+    uint32_t primask = Critical_Enter();
+
+    c->layer[layer].active = 0;
+    c->dirty = 1;
+    Critical_Exit(primask);
+}
+
+void LED_Compositor_Update(LED_Compositor_t *c)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t rgb[3] = { 0, 0, 0 };
+    int8_t i, top, base;
+
+    // 到期的图层自动隐藏，下层效果从未停止，直接按当前时刻的相位显示
+    for (i = 0; i < LED_LAYER_COUNT; i++) {
+        LED_LayerState_t *l = &c->layer[i];
+        if (l->active && l->expires && (int32_t)(now - l->expire_at) >= 0) {
+            l->active = 0;
+            c->dirty = 1;
+        }
+    }
+
+    top = _top_layer(c);
+    if (_can_follow(c, top)) {
+        c->dirty = 0;
+        RGB_LED_Follow(c->out, &c->layer[top].effect);
+        RGB_LED_Update(c->out);
+        return;
+    }
+
+    // 非渲染帧且图层无变化时直接返回
+    if (!c->dirty && !RGB_LED_FrameDue(c->out)) {
+        return;
+    }
+    c->dirty = 0;
+
+    // 被不透明图层完全遮住的图层不渲染
+    for (base = top; base > 0; base--) {
+        if (c->layer[base].active && c->layer[base].alpha == LED_ALPHA_OPAQUE) {
+            break;
+        }
+    }
+
+    for (i = base < 0 ? 0 : base; i <= top; i++) {
+        LED_LayerState_t *l = &c->layer[i];
+        if (!l->active) {
+            continue;
+        }
+        RGB_LED_Update(&l->effect);
+        rgb[0] = _blend(rgb[0], l->effect.cur_r, l->alpha);
+        rgb[1] = _blend(rgb[1], l->effect.cur_g, l->alpha);
+        rgb[2] = _blend(rgb[2], l->effect.cur_b, l->alpha);
+    }
+
+    // 颜色未变化的通道不会写 CCR
+    RGB_LED_SetStaticColor(c->out, rgb[0], rgb[1], rgb[2]);
+}
+
+// 是否需要逐帧合成 (不含图层到期)
+static uint8_t _needs_frames(const LED_Compositor_t *c)
+{
+    int8_t i, top;
+
+    if (c->dirty) {
+        return 1;
+    }
+    top = _top_layer(c);
+    if (_can_follow(c, top)) {
+        return RGB_LED_IsAnimating(c->out);
+    }
+    for (i = 0; i <= top; i++) {
+        if (c->layer[i].active && RGB_LED_IsAnimating(&c->layer[i].effect)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint8_t LED_Compositor_IsAnimating(const LED_Compositor_t *c)
+{
+    uint8_t i;
+
+    for (i = 0; i < LED_LAYER_COUNT; i++) {
+        if (c->layer[i].active && c->layer[i].expires) {
+            return 1;
+        }
+    }
+    return _needs_frames(c);
+}
+
+uint32_t LED_Compositor_NextDeadline(const LED_Compositor_t *c)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t next = UINT32_MAX;
+    uint8_t i;
+
+    if (_needs_frames(c)) {
+        return 0;
+    }
+    // 输出稳定时只需在最早的图层到期时刻醒来
+    for (i = 0; i < LED_LAYER_COUNT; i++) {
+        const LED_LayerState_t *l = &c->layer[i];
+        if (l->active && l->expires) {
+            int32_t remain = (int32_t)(l->expire_at - now);
+            if (remain <= 0) {
+                return 0;
+            }
+            if ((uint32_t)remain < next) {
+                next = (uint32_t)remain;
+            }
+        }
+    }
+    return next;
+}
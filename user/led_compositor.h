@@ -0,0 +1,78 @@
+/* === C/C++ Header代码文件: led_compositor.h === */
+#ifndef __LED_COMPOSITOR_H
+#define __LED_COMPOSITOR_H
+
+#include "rgb_led.h"
+#include <stdint.h>
+
+// 分层 LED 合成器
+//
+// 每个图层是一个虚拟 LED (RGB_LED_InitVirtual)，用原有的 RGB_LED_* 接口启动效果，
+// 合成器每个渲染帧从低到高按不透明度混合各激活图层，结果写入输出 LED。
+// 高层图层到期或隐藏后，低层图层的效果没有被改动过，呼吸/闪烁按时间戳计算，
+// 恢复显示时相位自然正确，无需重新初始化。
+// 最高的激活图层不透明且为呼吸/闪烁时，输出 LED 直接跟随该图层播放 (可使用 DMA 回放)。
+
+// 图层，编号越大优先级越高
+typedef enum {
+    LED_LAYER_BACKGROUND,
+    LED_LAYER_STATUS,
+    LED_LAYER_ALERT,
+    LED_LAYER_COUNT
+} LED_Layer_t;
+
+#define LED_ALPHA_OPAQUE   255
+
+typedef struct {
+    RGB_LED_t effect;     // 图层效果 (虚拟 LED)
+    uint8_t   active;     // 是否参与合成
+    uint8_t   alpha;      // 不透明度 (0-255)
+    uint8_t   expires;    // 是否有到期时刻
+    uint32_t  expire_at;  // 到期时刻 (HAL_GetTick)
+} LED_LayerState_t;
+
+typedef struct {
+    RGB_LED_t *out;                          // 输出 LED
+    LED_LayerState_t layer[LED_LAYER_COUNT];
+    volatile uint8_t dirty;                  // 图层配置有变化，下一次更新立即合成
+} LED_Compositor_t;
+
+/**
+ * @brief 绑定输出 LED 并初始化所有图层 (全部隐藏)
+ * @param out 已初始化的输出 LED
+ */
+void LED_Compositor_Init(LED_Compositor_t *c, RGB_LED_t *out);
+
+/**
+ * @brief 取得图层的虚拟 LED，用 RGB_LED_StartFlash 等接口设置该图层的效果
+ * @note  修改效果后调用 LED_Compositor_Show 使图层生效
+ */
+RGB_LED_t *LED_Compositor_Layer(LED_Compositor_t *c, LED_Layer_t layer);
+
+/**
+ * @brief 显示图层
+ * @param alpha 不透明度，LED_ALPHA_OPAQUE 完全覆盖下层
+ * @param duration_ms 显示时长 (ms)，到期后自动隐藏；0 表示一直显示
+ */
+void LED_Compositor_Show(LED_Compositor_t *c, LED_Layer_t layer, uint8_t alpha, uint32_t duration_ms);
+
+void LED_Compositor_Hide(LED_Compositor_t *c, LED_Layer_t layer);
+
+/**
+ * @brief 周期调用 (取代对输出 LED 的 RGB_LED_Update)，按输出 LED 的帧率合成
+ */
+void LED_Compositor_Update(LED_Compositor_t *c);
+
+/**
+ * @brief 判断是否需要周期调用 LED_Compositor_Update
+ * @return 1: 有动态效果、待到期图层或未合成的变化; 0: 输出稳定
+ */
+uint8_t LED_Compositor_IsAnimating(const LED_Compositor_t *c);
+
+/**
+ * @brief 距离下一次必须调用 LED_Compositor_Update 的毫秒数
+ * @return 0: 需要逐帧更新; UINT32_MAX: 输出稳定且没有待到期图层; 其他: 最早的图层到期时间
+ */
+uint32_t LED_Compositor_NextDeadline(const LED_Compositor_t *c);
+
+#endif
@@ -0,0 +1,188 @@
+/* === C代码文件: mempool.c === */
+#include "mempool.h"
+#include "critical.h"
+#include <string.h>
+
+_Static_assert(MEMPOOL_SMALL_SIZE % 4 == 0 && MEMPOOL_MEDIUM_SIZE % 4 == 0 && MEMPOOL_LARGE_SIZE % 4 == 0,
+               "block sizes must keep 4-byte alignment");
+_Static_assert(MEMPOOL_SMALL_SIZE < MEMPOOL_MEDIUM_SIZE && MEMPOOL_MEDIUM_SIZE < MEMPOOL_LARGE_SIZE,
+               "size classes must be in ascending order");
+
+// 各等级的存储区 (uint32_t 保证对齐)
+static uint32_t s_small[MEMPOOL_SMALL_COUNT * MEMPOOL_SMALL_SIZE / 4];
+static uint32_t s_medium[MEMPOOL_MEDIUM_COUNT * MEMPOOL_MEDIUM_SIZE / 4];
+static uint32_t s_large[MEMPOOL_LARGE_COUNT * MEMPOOL_LARGE_SIZE / 4];
+
+static MemPool_t s_pools[MEMPOOL_CLASS_COUNT];
+
+void MemPool_Init(MemPool_t *pool, void *storage, uint16_t block_size, uint8_t count)
+{
+    uint8_t *block = (uint8_t *)storage;
+    uint8_t i;
+
+    pool->base = block;
+    pool->block_size = block_size;
+    pool->count = count;
+    pool->used = 0;
+    pool->peak = 0;
+    pool->fails = 0;
+    pool->free = 0;
+    // 倒序挂入，第一次分配得到最低地址的块
+    for (i = count; i > 0; i--) {
+        void **b = (void **)(block + (uint32_t)(i - 1) * block_size);
+        *b = pool->free;
+        pool->free = b;
+    }
+}
+
+// 从空闲链表取一个块，count_fail 为1时池空计入失败次数
+static void *_take(MemPool_t *pool, uint8_t count_fail)
+{
+    uint32_t primask = Critical_Enter();
+    void **block = (void **)pool->free;
+
+    if (block) {
+        pool->free = *block;
+        if (++pool->used > pool->peak) {
+            pool->peak = pool->used;
+        }
+    } else if (count_fail) {
+        pool->fails++;
+    }
+    Critical_Exit(primask);
+    return block;
+}
+
+void *MemPool_Get(MemPool_t *pool)
+{
+    return _take(pool, 1);
+}
+
+void MemPool_Put(MemPool_t *pool, void *block)
+{
+    uint32_t primask = Critical_Enter();
+
+    *(void **)block = pool->free;
+    pool->free = block;
+    pool->used--;
+    Critical_Exit(primask);
+}
+
+void Mem_Init(void)
+{
+    MemPool_Init(&s_pools[MEMPOOL_SMALL], s_small, MEMPOOL_SMALL_SIZE, MEMPOOL_SMALL_COUNT);
+    MemPool_Init(&s_pools[MEMPOOL_MEDIUM], s_medium, MEMPOOL_MEDIUM_SIZE, MEMPOOL_MEDIUM_COUNT);
+    MemPool_Init(&s_pools[MEMPOOL_LARGE], s_large, MEMPOOL_LARGE_SIZE, MEMPOOL_LARGE_COUNT);
+}
+
+void *Mem_Alloc(size_t size)
+{
+    void *p;
+    uint8_t i;
+
+    for (i = 0; i < MEMPOOL_CLASS_COUNT && size > s_pools[i].block_size; i++) {
+    }
+    if (i == MEMPOOL_CLASS_COUNT) {
+        return 0;
+    }
+    // 只有合适的等级计入失败次数，借用更大的等级时不重复计数
+    p = MemPool_Get(&s_pools[i]);
+    for (i++; !p && i < MEMPOOL_CLASS_COUNT; i++) {
+        p = _take(&s_pools[i], 0);
+    }
+    return p;
+}
+
+// 按地址找到块所属的池，不属于任何池返回 NULL
+static MemPool_t *_owner(const void *p)
+{
+    uint8_t i;
+
+    for (i = 0; i < MEMPOOL_CLASS_COUNT; i++) {
+        MemPool_t *pool = &s_pools[i];
+        if ((const uint8_t *)p >= pool->base &&
+            (const uint8_t *)p < pool->base + (uint32_t)pool->block_size * pool->count) {
+            return pool;
+        }
+    }
+    return 0;
+}
+
+void Mem_Free(void *p)
+{
+    MemPool_t *pool;
+
+    if (!p) {
+        return;
+    }
+    pool = _owner(p);
+    if (pool) {
+        MemPool_Put(pool, p);
+    }
+}
+
+const MemPool_t *Mem_Pool(MemPool_Class_t cls)
+{
+    return &s_pools[cls];
+}
+
+// --- newlib 的可重入分配接口 ---
+//
+// NO_MALLOC 把对 _malloc_r 系列的引用改名为 __wrap_*，newlib 内部 (stdio 的缓冲区、
+// printf 的浮点转换等) 的分配由这里转到尺寸等级的池，printf 可以正常链接；
+// malloc/free 本身没有实现，应用代码直接调用仍然链接失败。
+// 超过最大等级的请求返回 NULL: stdout 申请 BUFSIZ 缓冲失败后 newlib 改为无缓冲，
+// 每次输出直接进入 _write (UART 发送环形缓冲区)。
+struct _reent;
+
+void *__wrap__malloc_r(struct _reent *r, size_t size)
+{
+    (void)r;
+    return Mem_Alloc(size);
+}
+
+void __wrap__free_r(struct _reent *r, void *p)
+{
+    (void)r;
+    Mem_Free(p);
+}
+
+void *__wrap__calloc_r(struct _reent *r, size_t n, size_t size)
+{
+    void *p;
+
+    (void)r;
+    if (size && n > SIZE_MAX / size) {
+        return 0;
+    }
+    p = Mem_Alloc(n * size);
+    if (p) {
+        memset(p, 0, n * size);
+    }
+    return p;
+}
+
+void *__wrap__realloc_r(struct _reent *r, void *p, size_t size)
+{
+    MemPool_t *pool;
+    void *q;
+
+    (void)r;
+    if (!p) {
+        return Mem_Alloc(size);
+    }
+    pool = _owner(p);
+    if (!pool) {
+        return 0;
+    }
+    // 原块放得下就原地返回，否则换到更大的等级
+    if (size <= pool->block_size) {
+        return p;
+    }
+    q = Mem_Alloc(size);
+    if (q) {
+        memcpy(q, p, pool->block_size);
+        MemPool_Put(pool, p);
+    }
+    return q;
+}
@@ -0,0 +1,88 @@
+/* === C/C++ Header代码文件: mempool.h === */
+#ifndef __MEMPOOL_H
+#define __MEMPOOL_H
+
+#include "stm32f0xx_hal.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// 固定块内存池，取代 newlib 的 malloc/_sbrk
+//
+// 每个池由编译期确定大小的静态数组切成等长的块，空闲块的首字串成单链表，
+// 分配和释放都只是一次链表头操作 (O(1))，不会产生碎片，耗时固定。
+// 临界区只包含链表头操作，可在中断中调用。
+//
+// Mem_Alloc/Mem_Free 在几个尺寸等级的池之上提供按字节数分配的接口:
+// 选择能容纳请求的最小等级，该等级用完时依次借用更大的等级。
+// 每个等级统计当前占用、峰值和分配失败次数，据此调整 MEMPOOL_*_COUNT。
+// 工程禁止直接使用 malloc (CMake 选项 NO_MALLOC，链接时检查)；newlib 内部 (stdio 等) 的
+// _malloc_r 系列经 __wrap__*_r 也由这些池分配，见 mempool.c。
+//
+// 默认配置按现有用户确定: 大块给 UART 发送环形缓冲区 (UartTx_Init 申请)，
+// 小/中块留给 newlib 的少量内部分配。增加用户时按 Mem_Pool 的峰值和失败次数调整。
+
+// 尺寸等级 (块大小须为4的倍数)
+#ifndef MEMPOOL_SMALL_SIZE
+#define MEMPOOL_SMALL_SIZE     16   // 事件记录等小对象
+#endif
+#ifndef MEMPOOL_SMALL_COUNT
+#define MEMPOOL_SMALL_COUNT    4
+#endif
+#ifndef MEMPOOL_MEDIUM_SIZE
+#define MEMPOOL_MEDIUM_SIZE    64   // 中等对象 (消息、描述符)
+#endif
+#ifndef MEMPOOL_MEDIUM_COUNT
+#define MEMPOOL_MEDIUM_COUNT   1
+#endif
+#ifndef MEMPOOL_LARGE_SIZE
+#define MEMPOOL_LARGE_SIZE     256  // UART 发送环形缓冲区 (UART_TX_BUF_SIZE)
+#endif
+#ifndef MEMPOOL_LARGE_COUNT
+#define MEMPOOL_LARGE_COUNT    1
+#endif
+
+typedef enum {
+    MEMPOOL_SMALL,
+    MEMPOOL_MEDIUM,
+    MEMPOOL_LARGE,
+    MEMPOOL_CLASS_COUNT
+} MemPool_Class_t;
+
+typedef struct {
+    void *free;           // 空闲链表头
+    uint8_t *base;        // 块存储区
+    uint16_t block_size;  // 块大小 (字节)
+    uint8_t count;        // 块数
+    uint8_t used;         // 当前占用块数
+    uint8_t peak;         // 占用峰值
+    uint16_t fails;       // 分配失败次数
+} MemPool_t;
+
+/**
+ * @brief 把存储区切成 count 个 block_size 字节的块，全部挂入空闲链表
+ * @param storage 存储区，4字节对齐，至少 block_size * count 字节
+ */
+void MemPool_Init(MemPool_t *pool, void *storage, uint16_t block_size, uint8_t count);
+
+// 取一个块，池已空返回 NULL 并计入失败次数
+void *MemPool_Get(MemPool_t *pool);
+
+// 归还 MemPool_Get 得到的块
+void MemPool_Put(MemPool_t *pool, void *block);
+
+// 初始化所有尺寸等级的池，须在第一次 Mem_Alloc 之前调用
+void Mem_Init(void);
+
+/**
+ * @brief 按字节数分配
+ * @return 块首地址，请求超过最大等级或所有可用等级都已用完时返回 NULL
+ */
+void *Mem_Alloc(size_t size);
+
+// 释放 Mem_Alloc 得到的块 (按地址找到所属的池)，NULL 忽略
+void Mem_Free(void *p);
+
+// 某个尺寸等级的池及其统计
+const MemPool_t *Mem_Pool(MemPool_Class_t cls);
+
+#endif
@@ -0,0 +1,45 @@
+/* === C代码文件: memstat.c === */
+#include "memstat.h"
+#include <stddef.h>
+
+// 链接脚本定义的区域边界
+extern uint32_t _sstack;
+extern uint32_t _estack;
+extern uint32_t _end;
+extern uint32_t _eheap;
+
+void *_sbrk(ptrdiff_t incr);
+
+// 从低地址向上找第一个被改写的字
+static const uint32_t *_first_used(const uint32_t *lo, const uint32_t *hi)
+{
+    while (lo < hi && *lo == MEMSTAT_PAINT) {
+        lo++;
+    }
+    return lo;
+}
+
+// 从高地址向下找最后一个被改写的字，返回其后一个字的地址
+static const uint32_t *_last_used(const uint32_t *lo, const uint32_t *hi)
+{
+    while (hi > lo && hi[-1] == MEMSTAT_PAINT) {
+        hi--;
+    }
+    return hi;
+}
+
+void MemStat_Get(MemStat_t *m)
+{
+    const uint32_t *stack_lo = &_sstack;
+    const uint32_t *stack_hi = &_estack;
+    const uint32_t *heap_lo = &_end;
+    const uint32_t *heap_hi = &_eheap;
+
+    m->stack_size = (uint32_t)((uintptr_t)stack_hi - (uintptr_t)stack_lo);
+    m->stack_peak = (uint32_t)((uintptr_t)stack_hi - (uintptr_t)_first_used(stack_lo, stack_hi));
+    m->stack_now = (uint32_t)((uintptr_t)stack_hi - __get_MSP());
+
+    m->heap_size = (uint32_t)((uintptr_t)heap_hi - (uintptr_t)heap_lo);
+    m->heap_peak = (uint32_t)((uintptr_t)_last_used(heap_lo, heap_hi) - (uintptr_t)heap_lo);
+    m->heap_brk = (uint32_t)((uintptr_t)_sbrk(0) - (uintptr_t)heap_lo);
+}
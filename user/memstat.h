@@ -0,0 +1,33 @@
+/* === C/C++ Header代码文件: memstat.h === */
+#ifndef __MEMSTAT_H
+#define __MEMSTAT_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 栈/堆用量统计
+//
+// 启动代码 (startup_stm32f030x6.s) 在进入 main 之前把栈区和堆区填满哨兵值，
+// 运行时从栈区底部向上找第一个被改写的字即得到栈的历史最大用量 (高水位)，
+// 从堆区顶部向下找最后一个被改写的字得到堆的高水位。
+// 栈区/堆区边界取自链接脚本的 _sstack/_estack 和 _end/_eheap，两种栈布局 (STACK_AT_BOTTOM) 通用。
+// 栈在 RAM 顶部时栈区紧接在堆区之上，栈溢出进入堆区后两者的高水位都显示为满。
+
+#define MEMSTAT_PAINT   0xC5C5C5C5u  // 哨兵值，与启动代码一致
+
+typedef struct {
+    uint32_t stack_size;  // 栈区大小 (_Min_Stack_Size)
+    uint32_t stack_peak;  // 栈高水位
+    uint32_t stack_now;   // 当前栈用量
+    uint32_t heap_size;   // 堆区大小
+    uint32_t heap_peak;   // 堆高水位 (被写过的最高位置)
+    uint32_t heap_brk;    // 当前 _sbrk 断点相对堆起点的偏移
+} MemStat_t;
+
+/**
+ * @brief 统计栈和堆的用量
+ * @note  需要扫描栈区和堆区 (最多几百个字)，不要在中断中频繁调用
+ */
+void MemStat_Get(MemStat_t *m);
+
+#endif
@@ -0,0 +1,216 @@
+/* === C代码文件: profiler.c === */
+#include "profiler.h"
+#include "critical.h"
+#include "memstat.h"
+#include "mempool.h"
+#include "uart_tx.h"
+#include <string.h>
+
+#if PROFILER_ENABLE
+
+static const char *const s_names[PROF_PROBE_COUNT] = {
+    "TIM17_IRQ",
+    "Button_ScanPort",
+    "SoftTimer_Tick",
+    "RGB_LED_Update",
+    "LED_Compositor",
+};
+
+static Prof_Stats_t s_stats[PROF_PROBE_COUNT];
+static uint16_t s_overhead; // 空探针的读数，记录时扣除
+
+// 4位数的位长
+static const uint8_t s_bitlen[16] = { 0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+
+// 直方图格号 = 位长 (Cortex-M0 没有 CLZ，查表)
+static uint8_t _bin(uint16_t x)
+{
+    uint8_t b = 0;
+
+    if (x >= 0x100u) {
+        x >>= 8;
+        b += 8;
+    }
+    if (x >= 0x10u) {
+        x >>= 4;
+        b += 4;
+    }
+    return (uint8_t)(b + s_bitlen[x]);
+}
+
+// 输出比发送缓冲区长，等待 DMA 腾出空间，不丢弃
+static void _putc(char c)
+{
+    UartTx_Send(&c, 1, UART_TX_BLOCK);
+}
+
+static void _puts(const char *s)
+{
+    UartTx_Send(s, (uint16_t)strlen(s), UART_TX_BLOCK);
+}
+
+// 十进制输出，不依赖 printf
+static void _putu(uint32_t v)
+{
+    char buf[10];
+    uint8_t n = 0;
+
+    do {
+        buf[n++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v);
+    while (n) {
+        _putc(buf[--n]);
+    }
+}
+
+void Prof_Reset(void)
+{
+    uint32_t primask = Critical_Enter();
+    uint8_t i, b;
+
+    for (i = 0; i < PROF_PROBE_COUNT; i++) {
+        s_stats[i].count = 0;
+        s_stats[i].sum = 0;
+        s_stats[i].min = 0xFFFF;
+        s_stats[i].max = 0;
+        for (b = 0; b < PROF_HIST_BINS; b++) {
+            s_stats[i].hist[b] = 0;
+        }
+    }
+    Critical_Exit(primask);
+}
+
+void Prof_Init(void)
+{
+    uint32_t primask;
+    uint16_t start;
+
+    // TIM3: 向上计数，ARR 取满，自由运行
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    TIM3->CR1 = 0;
+    TIM3->PSC = PROFILER_PRESCALER - 1;
+    TIM3->ARR = 0xFFFF;
+    TIM3->EGR = TIM_EGR_UG;
+    TIM3->CR1 = TIM_CR1_CEN;
+
+    // 与 PROF_ENTER/PROF_EXIT 相同的两次读数之差即探针开销
+    primask = Critical_Enter();
+    start = (uint16_t)TIM3->CNT;
+    s_overhead = (uint16_t)((uint16_t)TIM3->CNT - start);
+    Critical_Exit(primask);
+
+    Prof_Reset();
+}
+
+void Prof_Record(Prof_Probe_t id, uint16_t ticks)
+{
+    Prof_Stats_t *p = &s_stats[id];
+    uint8_t bin;
+    uint32_t primask;
+
+    ticks = ticks > s_overhead ? (uint16_t)(ticks - s_overhead) : 0;
+    bin = _bin(ticks);
+
+    // 同一探针可能在不同优先级的中断中记录
+    primask = Critical_Enter();
+    p->count++;
+    p->sum += ticks;
+    if (ticks < p->min) {
+        p->min = ticks;
+    }
+    if (ticks > p->max) {
+        p->max = ticks;
+    }
+    if (p->hist[bin] != 0xFFFF) {
+        p->hist[bin]++;
+    }
+    Critical_Exit(primask);
+}
+
+const Prof_Stats_t *Prof_Get(Prof_Probe_t id)
+{
+    return &s_stats[id];
+}
+
+// 每个探针两行:
+//   <名称> n=<次数> min=<最小> max=<最大> avg=<平均>
+//   hist <第0格> <第1格> ... <第16格>
+// 之后每个内存池等级一行，最后一行为栈/堆用量 (字节):
+//   pool <块大小> used=<占用>/<块数> peak=<峰值> fail=<失败次数>
+//   mem stack=<高水位>/<大小> now=<当前> heap=<高水位>/<大小> brk=<断点>
+//   uart sent=<写入字节数> drop=<丢弃字节数> peak=<缓冲区占用峰值>
+void Prof_Dump(void)
+{
+    const UartTx_Stats_t *uart = UartTx_Stats();
+    MemStat_t mem;
+    uint8_t i, b;
+
+    _puts("prof: 1 tick = ");
+    _putu(PROFILER_PRESCALER);
+    _puts(" cycles\r\n");
+    for (i = 0; i < PROF_PROBE_COUNT; i++) {
+        Prof_Stats_t s;
+        uint32_t primask = Critical_Enter();
+        s = s_stats[i]; // 拷贝快照，输出期间统计可以继续
+        Critical_Exit(primask);
+
+        _puts(s_names[i]);
+        _puts(" n=");
+        _putu(s.count);
+        if (s.count) {
+            _puts(" min=");
+            _putu(s.min);
+            _puts(" max=");
+            _putu(s.max);
+            _puts(" avg=");
+            _putu(s.sum / s.count);
+        }
+        _puts("\r\nhist");
+        for (b = 0; b < PROF_HIST_BINS; b++) {
+            _putc(' ');
+            _putu(s.hist[b]);
+        }
+        _puts("\r\n");
+    }
+
+    for (i = 0; i < MEMPOOL_CLASS_COUNT; i++) {
+        const MemPool_t *pool = Mem_Pool((MemPool_Class_t)i);
+        _puts("pool ");
+        _putu(pool->block_size);
+        _puts(" used=");
+        _putu(pool->used);
+        _putc('/');
+        _putu(pool->count);
+        _puts(" peak=");
+        _putu(pool->peak);
+        _puts(" fail=");
+        _putu(pool->fails);
+        _puts("\r\n");
+    }
+
+    MemStat_Get(&mem);
+    _puts("mem stack=");
+    _putu(mem.stack_peak);
+    _putc('/');
+    _putu(mem.stack_size);
+    _puts(" now=");
+    _putu(mem.stack_now);
+    _puts(" heap=");
+    _putu(mem.heap_peak);
+    _putc('/');
+    _putu(mem.heap_size);
+    _puts(" brk=");
+    _putu(mem.heap_brk);
+    _puts("\r\n");
+
+    _puts("uart sent=");
+    _putu(uart->written);
+    _puts(" drop=");
+    _putu(uart->dropped);
+    _puts(" peak=");
+    _putu(uart->peak);
+    _puts("\r\n");
+}
+
+#endif
@@ -0,0 +1,75 @@
+/* === C/C++ Header代码文件: profiler.h === */
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 中断/代码段耗时统计
+//
+// Cortex-M0 没有 DWT 周期计数器，改用空闲的 TIM3 作为自由运行的16位计数器 (默认不分频，1个计数=1个CPU周期)。
+// PROF_ENTER/PROF_EXIT 在代码段两端读计数器，差值记入固定的 RAM 统计表:
+// 次数、最小/最大/平均值和 log2 直方图 (第 k 格为 [2^(k-1), 2^k) 个计数)。
+// 计数器16位，单次测量不能超过 65535 个计数 (不分频时约 1.36ms)，更长的代码段须增大 PROFILER_PRESCALER。
+// 结果用 Prof_Dump 经 USART1 TX 发送缓冲区 (uart_tx.h，须先调用 UartTx_Init) 输出为文本。
+//
+// PROFILER_ENABLE 为0 (默认) 时所有探针和接口都编译为空，不占用 TIM3 和 RAM。
+// 在 CMake 中用 -DPROFILER=ON 打开。
+
+#ifndef PROFILER_ENABLE
+#define PROFILER_ENABLE      0
+#endif
+#ifndef PROFILER_PRESCALER
+#define PROFILER_PRESCALER   1       // TIM3 分频系数
+#endif
+
+#define PROF_HIST_BINS       17      // 0 和 1~16 位长，覆盖16位计数范围
+
+// 探针编号，新增探针时同步修改 profiler.c 中的名称表
+typedef enum {
+    PROF_TICK_IRQ,       // TIM17_IRQHandler
+    PROF_BUTTON_SCAN,    // Button_ScanPort
+    PROF_SOFT_TIMER,     // SoftTimer_Tick
+    PROF_LED_UPDATE,     // RGB_LED_Update
+    PROF_COMPOSITOR,     // LED_Compositor_Update
+    PROF_PROBE_COUNT
+} Prof_Probe_t;
+
+typedef struct {
+    uint32_t count;                 // 测量次数
+    uint32_t sum;                   // 累计计数，用于求平均
+    uint16_t min;
+    uint16_t max;
+    uint16_t hist[PROF_HIST_BINS];  // log2 直方图，饱和计数
+} Prof_Stats_t;
+
+#if PROFILER_ENABLE
+
+// 在代码段开头和结尾成对使用，同一作用域内每个探针只能有一对
+#define PROF_ENTER(id)  uint16_t _prof_start_##id = (uint16_t)TIM3->CNT
+#define PROF_EXIT(id)   Prof_Record(id, (uint16_t)((uint16_t)TIM3->CNT - _prof_start_##id))
+
+// 启动 TIM3，清空统计表并测量探针自身开销 (之后每次记录时扣除)
+void Prof_Init(void);
+
+void Prof_Record(Prof_Probe_t id, uint16_t ticks);
+
+// 清空统计表
+void Prof_Reset(void);
+
+const Prof_Stats_t *Prof_Get(Prof_Probe_t id);
+
+// 从 USART1 输出所有探针的统计结果 (发送缓冲区满时等待)，应在主循环中调用
+void Prof_Dump(void);
+
+#else
+
+#define PROF_ENTER(id)
+#define PROF_EXIT(id)
+#define Prof_Init()        ((void)0)
+#define Prof_Reset()       ((void)0)
+#define Prof_Dump()        ((void)0)
+
+#endif
+
+#endif
@@ -1,53 +1,644 @@
 /* === C代码文件: rgb_led.c === */
 #include "rgb_led.h"
-#include <math.h> // 用于sinf函数
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846f
-#endif
+#include "critical.h"
+#include "sine_table.h"
+#include "cie_table.h"
+#include "soft_pwm.h"
+#include "ws2812.h"
+#include "profiler.h"
+#include "trace.h"
 
 // --- 内部辅助函数 ---
 
 /**
- * @brief 根据颜色值(0-255)和连接方式设置硬件PWM占空比
- * @param htim      定时器句柄
- * @param channel   定时器通道
- * @param color_val 颜色亮度值 (0-255)
+ * @brief 将线性占空比 (Q16) 按连接方式换算为PWM比较值
+ * @param max_duty 该通道定时器的 ARR (初始化时缓存，避免每次读寄存器)
+ * @param duty_q16 线性占空比，0~65535
  * @param connection_type LED连接方式 (共阴/共阳)
  */
-static void _set_pwm_by_color(TIM_HandleTypeDef *htim, uint32_t channel, 
-                              uint8_t color_val, LED_Connection_t connection_type)
+static uint16_t _duty_to_compare(uint16_t max_duty, uint32_t duty_q16, LED_Connection_t connection_type)
 {
-    // 获取定时器的自动重载值 (ARR)，这就是PWM的最大计数值
-    uint32_t max_duty = __HAL_TIM_GET_AUTORELOAD(htim);
-    
-    // 将 0-255 的颜色值映射到 0-max_duty 的PWM比较值
-    uint32_t compare_val = ((uint32_t)color_val * max_duty) / 255;
+    // 按 ARR 缩放: 只有一次乘法，没有除法，低亮度段可以用满 ARR 的分辨率 (ARR=999 时约1000级)
+    uint32_t compare_val = (duty_q16 * max_duty + 0x8000u) >> 16;
 
     // 根据连接方式调整最终的比较值
     if (connection_type == LED_CONNECTION_COMMON_ANODE) {
         // 共阳极，逻辑反转。0%占空比最亮，100%占空比最暗。
         compare_val = max_duty - compare_val;
     }
-    
-    // 设置PWM比较寄存器值
-    __HAL_TIM_SET_COMPARE(htim, channel, compare_val);
+    return (uint16_t)compare_val;
+}
+
+/**
+ * @brief 将颜色值(0-255)按连接方式换算为PWM比较值
+ * @param color_val 感知亮度值 (0-255)，经 CIE 明度表校正为线性占空比
+ */
+static uint16_t _color_to_compare(uint16_t max_duty, uint8_t color_val, LED_Connection_t connection_type)
+{
+    return _duty_to_compare(max_duty, cie_q16[color_val], connection_type);
+}
+
+/**
+ * @brief 16位感知亮度经 CIE 明度表换算为线性占空比，表项之间线性插值
+ * @param level_q16 感知亮度，0~65535
+ * @return 线性占空比 (Q16)
+ * @note  呼吸等连续变化的亮度不先量化为 8 位颜色值，低亮度段也能平滑过渡
+ */
+static uint32_t _cie_interp_q16(uint32_t level_q16)
+{
+    // 表下标 = level * 255 / 65536，高16位为下标，低16位为两项之间的位置
+    uint32_t pos = level_q16 * 255u;
+    uint32_t idx = pos >> 16;
+    uint32_t frac = pos & 0xFFFFu;
+    uint32_t a, b;
+
+    if (idx >= 255) {
+        return cie_q16[255];
+    }
+    a = cie_q16[idx];
+    b = cie_q16[idx + 1];
+    // 表单调递增，相邻两项之差不到 1000，乘积不会溢出
+    return a + (((b - a) * frac + 0x8000u) >> 16);
+}
+
+// --- 输出后端 ---
+
+// 硬件定时器PWM: 比较值直接写 CCR
+static void _tim_write(TIM_HandleTypeDef *htim, uint32_t channel, uint16_t value)
+{
+    __HAL_TIM_SET_COMPARE(htim, channel, value);
+}
+
+static uint16_t _tim_read(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    return (uint16_t)__HAL_TIM_GET_COMPARE(htim, channel);
+}
+
+static uint16_t _tim_max_level(TIM_HandleTypeDef *htim)
+{
+    return (uint16_t)__HAL_TIM_GET_AUTORELOAD(htim);
+}
+
+static const RGB_LED_Backend_t s_backend_tim = {
+    _tim_write, _tim_read, _tim_max_level, 0
+};
+
+// GPIO 软件PWM (BCM): 比较值即 SoftPWM 占空比，一次颜色更新后重建位平面
+static void _soft_write(TIM_HandleTypeDef *htim, uint32_t channel, uint16_t value)
+{
+    (void)htim;
+    SoftPWM_Set((uint8_t)channel, value);
+}
+
+static uint16_t _soft_read(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    (void)htim;
+    return SoftPWM_Get((uint8_t)channel);
+}
+
+static uint16_t _soft_max_level(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+    return SOFT_PWM_MAX_LEVEL;
+}
+
+static const RGB_LED_Backend_t s_backend_soft = {
+    _soft_write, _soft_read, _soft_max_level, SoftPWM_Flush
+};
+
+// WS2812 灯带: 比较值即 8 位颜色值，一次颜色更新后请求发送整条灯带
+static void _ws2812_write(TIM_HandleTypeDef *htim, uint32_t channel, uint16_t value)
+{
+    (void)htim;
+    WS2812_SetChannel((uint16_t)channel, (uint8_t)value);
+}
+
+static uint16_t _ws2812_read(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    (void)htim;
+    return WS2812_GetChannel((uint16_t)channel);
+}
+
+static uint16_t _ws2812_max_level(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+    return 255;
+}
+
+static const RGB_LED_Backend_t s_backend_ws2812 = {
+    _ws2812_write, _ws2812_read, _ws2812_max_level, WS2812_Show
+};
+
+// 虚拟 LED: 不驱动硬件，只记录 cur_x，供合成器等上层读取
+static uint16_t _none_read(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    (void)htim;
+    (void)channel;
+    return 0;
+}
+
+static uint16_t _none_max_level(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+    return 255;
+}
+
+static const RGB_LED_Backend_t s_backend_none = {
+    0, _none_read, _none_max_level, 0
+};
+
+/**
+ * @brief 写入一个通道的比较值，与上次写入的值相同时跳过
+ * @param committed 该通道最近一次写入的比较值
+ * @return 1: 已写入; 0: 未变化
+ */
+static uint8_t _commit_compare(RGB_LED_t *led, TIM_HandleTypeDef *htim, uint32_t channel,
+                               uint16_t *committed, uint16_t compare)
+{
+    if (*committed == compare) {
+        led->ccr_writes_skipped++;
+        return 0;
+    }
+    *committed = compare;
+    led->backend->write(htim, channel, compare);
+    return 1;
+}
+
+// 写入三个通道的比较值，有通道变化时刷新后端
+static void _commit_rgb(RGB_LED_t *led, uint16_t compare_r, uint16_t compare_g, uint16_t compare_b)
+{
+    uint8_t written;
+
+    written  = _commit_compare(led, led->htim_r, led->channel_r, &led->ccr_r, compare_r);
+    written |= _commit_compare(led, led->htim_g, led->channel_g, &led->ccr_g, compare_g);
+    written |= _commit_compare(led, led->htim_b, led->channel_b, &led->ccr_b, compare_b);
+    if (written && led->backend->flush) {
+        led->backend->flush();
+    }
+}
+
+static void _apply_color(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b)
+{
+    led->cur_r = r;
+    led->cur_g = g;
+    led->cur_b = b;
+    if (!led->backend->write) {
+        return;
+    }
+
+    _commit_rgb(led, _color_to_compare(led->max_duty_r, r, led->connection_type),
+                     _color_to_compare(led->max_duty_g, g, led->connection_type),
+                     _color_to_compare(led->max_duty_b, b, led->connection_type));
+}
+
+// 白色呼吸: 16位亮度经插值的 CIE 曲线直接换算比较值，cur_x 只记录 8 位近似值
+static void _apply_level(RGB_LED_t *led, uint32_t level_q16)
+{
+    uint32_t duty = _cie_interp_q16(level_q16);
+
+    led->cur_r = led->cur_g = led->cur_b = (uint8_t)((level_q16 * 255 + 32768) >> 16);
+    if (!led->backend->write) {
+        return;
+    }
+
+    _commit_rgb(led, _duty_to_compare(led->max_duty_r, duty, led->connection_type),
+                     _duty_to_compare(led->max_duty_g, duty, led->connection_type),
+                     _duty_to_compare(led->max_duty_b, duty, led->connection_type));
+}
+
+// CCR 被 CPU 以外的途径改写后 (初始化、DMA 回放)，以寄存器实际值为准
+static void _sync_compare(RGB_LED_t *led)
+{
+    led->ccr_r = led->backend->read(led->htim_r, led->channel_r);
+    led->ccr_g = led->backend->read(led->htim_g, led->channel_g);
+    led->ccr_b = led->backend->read(led->htim_b, led->channel_b);
+}
+
+/**
+ * @brief 查表计算正弦值，纯整数运算 (M0 无FPU，避免软件浮点和 libm)
+ * @param phase 相位，0~65535 对应 0~2*pi
+ * @return sin(phase) 的 Q15 值，表项之间线性插值
+ */
+static int32_t _sine_q15(uint16_t phase)
+{
+    // 高2位为象限，其后6位为表下标，低8位用于插值
+    uint8_t quadrant = phase >> 14;
+    uint8_t idx = (phase >> 8) & (SINE_QUARTER_STEPS - 1);
+    int32_t frac = phase & 0xFF;
+    int32_t a, b;
+
+    if (quadrant & 1) {
+        // 第2、4象限镜像
+        a = sine_q15_quarter[SINE_QUARTER_STEPS - idx];
+        b = sine_q15_quarter[SINE_QUARTER_STEPS - idx - 1];
+    } else {
+        a = sine_q15_quarter[idx];
+        b = sine_q15_quarter[idx + 1];
+    }
+    a += ((b - a) * frac) >> 8;
+
+    // 第3、4象限取反
+    return (quadrant & 2) ? -a : a;
+}
+
+// 呼吸亮度 y = (1 - cos(x)) / 2，从最暗开始，返回 Q16 (0~65535)
+// 相位 = 经过时间 * 每毫秒相位增量，自然按 2^32 回绕，无需取模
+static uint32_t _breath_level_q16(const RGB_LED_t *led, uint32_t elapsed_time)
+{
+    uint16_t phase = (uint16_t)((elapsed_time * led->phase_step) >> 16);
+    return (uint32_t)(32768 - _sine_q15((uint16_t)(phase + 0x4000)));
+}
+
+/**
+ * @brief 计算动态效果在 elapsed_time 时刻的颜色
+ * @param rgb 输出的颜色值 (0-255)
+ */
+static void _render_color(const RGB_LED_t *led, uint32_t elapsed_time, uint8_t rgb[3])
+{
+    switch (led->mode)
+    {
+        case LED_MODE_BREATH:
+        {
+            // 白色呼吸灯，所有通道使用相同亮度。这里的 8 位值只给虚拟灯层和渐变起点使用，
+            // 写硬件时由 _apply_level 按 16 位亮度换算
+            uint8_t color_val = (uint8_t)((_breath_level_q16(led, elapsed_time) * 255 + 32768) >> 16);
+            rgb[0] = rgb[1] = rgb[2] = color_val;
+            break;
+        }
+
+        case LED_MODE_FLASH:
+        {
+            if ((elapsed_time % led->period) < led->on_time) {
+                // 亮灯时间
+                rgb[0] = led->target_r;
+                rgb[1] = led->target_g;
+                rgb[2] = led->target_b;
+            } else {
+                // 灭灯时间
+                rgb[0] = rgb[1] = rgb[2] = 0;
+            }
+            break;
+        }
+
+        default:
+            rgb[0] = rgb[1] = rgb[2] = 0;
+            break;
+    }
+}
+
+// --- 效果程序解释器 ---
+
+static uint16_t _program_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// 渐变插值: 进度为 Q16，起点为 prog_x，终点为 target_x
+static uint8_t _ramp_lerp(uint8_t from, uint8_t to, uint32_t progress_q16)
+{
+    return (uint8_t)(from + (((int32_t)to - (int32_t)from) * (int32_t)progress_q16 >> 16));
+}
+
+/**
+ * @brief 从上一条指令的截止时刻开始一条有时长的指令 (HOLD/RAMP)
+ * @note  起点取上一截止时刻而非当前时刻，长时间运行也不会累积漂移
+ * @return 1: 指令尚未结束; 0: 指令在 now 之前已经结束 (时长为0或更新被耽搁)
+ */
+static uint8_t _program_begin_timed(RGB_LED_t *led, uint16_t duration, uint32_t now)
+{
+    led->timer_start = led->deadline;
+    led->deadline += duration;
+    return (int32_t)(now - led->deadline) < 0;
+}
+
+// 按当前时刻输出渐变颜色，每毫秒进度增量在指令开始时算好，这里只有乘法
+static void _program_ramp_apply(RGB_LED_t *led, uint32_t now)
+{
+    uint32_t progress = ((now - led->timer_start) * led->phase_step) >> 16;
+    _apply_color(led, _ramp_lerp(led->prog_r, led->target_r, progress),
+                      _ramp_lerp(led->prog_g, led->target_g, progress),
+                      _ramp_lerp(led->prog_b, led->target_b, progress));
+}
+
+/**
+ * @brief 执行效果程序，每个 tick 调用一次
+ * @note  当前指令未到期时: 保持指令直接返回，渐变指令做一次插值，均为 O(1)。
+ *        到期后连续执行后续指令直到开始一条新的有时长指令，最多 RGB_LED_PROGRAM_MAX_STEPS 条。
+ */
+static void _program_run(RGB_LED_t *led, uint32_t now)
+{
+    const uint8_t *op;
+    uint8_t steps;
+
+    if ((int32_t)(now - led->deadline) < 0) {
+        if (led->ramping) {
+            _program_ramp_apply(led, now);
+        }
+        return;
+    }
+
+    // 上一条渐变结束，精确落在目标颜色
+    if (led->ramping) {
+        led->ramping = 0;
+        led->prog_r = led->target_r;
+        led->prog_g = led->target_g;
+        led->prog_b = led->target_b;
+        _apply_color(led, led->prog_r, led->prog_g, led->prog_b);
+    }
+
+    for (steps = 0; steps < RGB_LED_PROGRAM_MAX_STEPS; steps++) {
+        op = &led->program[led->pc];
+        switch (op[0])
+        {
+            case LED_OP_SET:
+                led->prog_r = op[1];
+                led->prog_g = op[2];
+                led->prog_b = op[3];
+                _apply_color(led, led->prog_r, led->prog_g, led->prog_b);
+                led->pc += LED_SET_LEN;
+                break;
+
+            case LED_OP_HOLD:
+                led->pc += LED_HOLD_LEN;
+                if (_program_begin_timed(led, _program_u16(&op[1]), now)) {
+                    return;
+                }
+                break;
+
+            case LED_OP_RAMP:
+            {
+                uint16_t duration = _program_u16(&op[1]);
+                led->target_r = op[3];
+                led->target_g = op[4];
+                led->target_b = op[5];
+                led->pc += LED_RAMP_LEN;
+                if (_program_begin_timed(led, duration, now)) {
+                    // 除法只在指令开始时做一次 (duration > 0，否则上面已判定为结束)
+                    led->phase_step = 0xFFFFFFFFu / duration;
+                    led->ramping = 1;
+                    _program_ramp_apply(led, now);
+                    return;
+                }
+                // 已错过整段渐变，直接跳到目标颜色
+                led->prog_r = led->target_r;
+                led->prog_g = led->target_g;
+                led->prog_b = led->target_b;
+                _apply_color(led, led->prog_r, led->prog_g, led->prog_b);
+                break;
+            }
+
+            case LED_OP_LOOP:
+                if (led->loop_count == 0) {
+                    led->loop_count = op[1];
+                }
+                if (led->loop_count > 1) {
+                    led->loop_count--;
+                    led->pc = op[2];
+                } else {
+                    // 循环结束，计数清零以便下次再进入
+                    led->loop_count = 0;
+                    led->pc += LED_LOOP_LEN;
+                }
+                break;
+
+            case LED_OP_JUMP:
+                led->pc = op[1];
+                break;
+
+            default:
+                // LED_OP_END 或非法操作码: 保持当前颜色，停止解释
+                led->mode = LED_MODE_STATIC;
+                return;
+        }
+    }
+
+    // 本次执行的指令数已达上限，从当前时刻重新计时，下个 tick 继续
+    led->deadline = now;
+}
+
+// --- 渐变 (淡入淡出) ---
+
+// 渐变复用效果程序的 RAMP 状态: 起点 prog_x，终点 target_x，截止时刻 deadline
+static void _fade_run(RGB_LED_t *led, uint32_t now)
+{
+    if ((int32_t)(now - led->deadline) < 0) {
+        _program_ramp_apply(led, now);
+        return;
+    }
+    _apply_color(led, led->target_r, led->target_g, led->target_b);
+    led->mode = LED_MODE_STATIC;
+}
+
+// --- HSV ---
+
+// x / 255 向下取整，x 不超过 65534 (255*255 以内) 时准确，避免 M0 上的软件除法
+static inline uint32_t _div255(uint32_t x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+// --- DMA 波形回放 ---
+
+static uint16_t s_dma_frames[RGB_LED_DMA_MAX_FRAMES][3]; // 每帧 CCR2/CCR3/CCR4
+static uint32_t s_dma_ccer;                                // 启动回放前的输出极性
+static uint32_t s_dma_count;                               // 缓冲区中的帧数
+
+#define RGB_LED_DMA_POLARITY   (TIM_CCER_CC2P | TIM_CCER_CC3P | TIM_CCER_CC4P)
+
+// DMA 回放要求 R/G/B 依次为 TIM1 的 CH2/CH3/CH4，这样一次 DMA burst 即可写入3个 CCR
+static uint8_t _dma_supported(const RGB_LED_t *led)
+{
+    return led->backend == &s_backend_tim && led->htim_r->Instance == TIM1 && led->htim_g == led->htim_r && led->htim_b == led->htim_r &&
+           led->channel_r == TIM_CHANNEL_2 && led->channel_g == TIM_CHANNEL_3 &&
+           led->channel_b == TIM_CHANNEL_4;
+}
+
+static void _dma_stop(RGB_LED_t *led)
+{
+    if (!led->dma_running) {
+        return;
+    }
+    DMA1_Channel5->CCR &= ~DMA_CCR_EN;
+    TIM1->DIER &= ~TIM_DIER_UDE;
+    TIM1->RCR = 0;
+    TIM1->CCER = (TIM1->CCER & ~RGB_LED_DMA_POLARITY) | s_dma_ccer;
+    led->dma_running = 0;
+    _sync_compare(led);
+}
+
+/**
+ * @brief 把当前效果渲染为一个周期的 CCR 帧序列，由 TIM1 更新事件触发 DMA burst 循环写入 CCR2~4
+ * @note  帧率由 TIM1 重复计数器 RCR 决定: 每 (RCR+1) 个 PWM 周期传输一帧。
+ *        选择能整除一个周期的 PWM 周期数、且帧数不超过 RGB_LED_DMA_MAX_FRAMES 的最小 RCR，
+ *        循环回放的周期与 CPU 更新完全相同，不会逐圈漂移；找不到这样的 RCR 时退回 CPU 更新。
+ *        帧间隔也不能比 CPU 更新的帧间隔 (frame_interval) 更长，否则呼吸的低亮度段会重新出现台阶，
+ *        周期太长、缓冲区放不下时同样退回 CPU 更新。
+ *        中途启动或恢复的效果与 CPU 更新时的相位一致: 整周期模式从当前时刻的相位开始渲染
+ *        (循环缓冲区总是从第0帧开始播放)，CPU 零参与。
+ *        半周期模式只渲染 [T/4, 3T/4)，DMA 传输完成中断里翻转输出极性得到另一半
+ *        (正弦呼吸满足 y(t + T/2) = 1 - y(t))，同样帧数下帧率翻倍或同样帧率下 RAM 减半。
+ *        缓冲区两端都在 y = 1/2 处，翻转极性时波形连续，所以缓冲区不能按当前相位旋转:
+ *        首圈从当前相位所在的帧开始单次传输，播完后在中断里改为从第0帧开始循环。
+ *        半周期模式直接按线性占空比渲染 (CIE 校正后的波形不满足上述对称性)。
+ * @return 1: 已启动 DMA 回放; 0: 条件不满足，继续由 CPU 更新
+ */
+static uint8_t _dma_start(RGB_LED_t *led)
+{
+    uint8_t half = (led->playback == LED_PLAYBACK_DMA_HALF && led->mode == LED_MODE_BREATH);
+    uint32_t timer_hz, update_hz, cycles, rcr_plus1, frames, elapsed, start, i;
+    uint32_t first = 0;   // 首圈从第几帧开始 (只用于半周期模式)
+    uint8_t invert = 0;   // 首圈是否处于翻转极性的半周期
+
+    if (led->playback == LED_PLAYBACK_CPU || !_dma_supported(led) || led->period == 0) {
+        return 0;
+    }
+
+    // PWM 周期频率 (TIM1 挂在 APB 上，APB 不分频时定时器时钟等于 PCLK)
+    // 周期须正好是整数个 PWM 周期 (半周期模式为整数个的两倍)，否则回放会逐圈漂移
+    timer_hz = HAL_RCC_GetPCLK1Freq();
+    update_hz = timer_hz / ((TIM1->PSC + 1) * (TIM1->ARR + 1));
+    if (update_hz == 0 || update_hz * (TIM1->PSC + 1) * (TIM1->ARR + 1) != timer_hz ||
+        led->period > UINT32_MAX / update_hz) {
+        return 0;
+    }
+    cycles = led->period * update_hz;
+    if (cycles % 1000 != 0 || (half && cycles % 2000 != 0)) {
+        return 0;
+    }
+    cycles = half ? cycles / 2000 : cycles / 1000;
+    if (cycles == 0) {
+        return 0;
+    }
+
+    // 最小的能整除 cycles 的 RCR+1 (帧数越多越平滑)，RCR 只有8位
+    for (rcr_plus1 = (cycles + RGB_LED_DMA_MAX_FRAMES - 1) / RGB_LED_DMA_MAX_FRAMES; rcr_plus1 <= 256; rcr_plus1++) {
+        if (cycles % rcr_plus1 == 0) {
+            break;
+        }
+    }
+    if (rcr_plus1 > 256 || rcr_plus1 * 1000 > (uint64_t)led->frame_interval * update_hz) {
+        return 0;
+    }
+    frames = cycles / rcr_plus1;
+
+    // 效果启动以来的时间 (以 PWM 周期为单位)
+    elapsed = (HAL_GetTick() - led->timer_start) % led->period;
+    start = elapsed * update_hz / 1000;
+    if (half) {
+        // 缓冲区固定从 T/4 开始 (cycles 为半周期，T/4 即 cycles/2)，按当前时刻取最近的帧和所在的半周期
+        uint32_t u = (start + 2 * cycles - cycles / 2) % (2 * cycles);
+        if (u >= cycles) {
+            u -= cycles;
+            invert = 1;
+        }
+        first = (u + rcr_plus1 / 2) / rcr_plus1;
+        if (first == frames) {
+            first = 0;
+            invert ^= 1;
+        }
+        start = cycles / 2;
+    }
+
+    // 渲染在调用者的上下文完成 (主循环，或渲染内核任务中的 RGB_LED_Follow)，不在中断里，除法只在这里出现
+    for (i = 0; i < frames; i++) {
+        uint32_t t = ((start + i * rcr_plus1) * 1000) / update_hz;
+        if (half) {
+            uint32_t level = _breath_level_q16(led, t);
+            uint16_t duty = (uint16_t)((level * led->max_duty_r + 0x8000u) >> 16);
+            if (led->connection_type == LED_CONNECTION_COMMON_ANODE) {
+                duty = led->max_duty_r - duty;
+            }
+            s_dma_frames[i][0] = s_dma_frames[i][1] = s_dma_frames[i][2] = duty;
+        } else if (led->mode == LED_MODE_BREATH) {
+            uint32_t duty = _cie_interp_q16(_breath_level_q16(led, t));
+            s_dma_frames[i][0] = _duty_to_compare(led->max_duty_r, duty, led->connection_type);
+            s_dma_frames[i][1] = _duty_to_compare(led->max_duty_g, duty, led->connection_type);
+            s_dma_frames[i][2] = _duty_to_compare(led->max_duty_b, duty, led->connection_type);
+        } else {
+            uint8_t rgb[3];
+            _render_color(led, t, rgb);
+            s_dma_frames[i][0] = _color_to_compare(led->max_duty_r, rgb[0], led->connection_type);
+            s_dma_frames[i][1] = _color_to_compare(led->max_duty_g, rgb[1], led->connection_type);
+            s_dma_frames[i][2] = _color_to_compare(led->max_duty_b, rgb[2], led->connection_type);
+        }
+    }
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    s_dma_ccer = TIM1->CCER & RGB_LED_DMA_POLARITY;
+
+    // TIM1_UP 对应 DMA1 通道5: 存储器 -> TIM1->DMAR，16位，循环模式
+    DMA1_Channel5->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF5;
+    DMA1_Channel5->CPAR = (uint32_t)&TIM1->DMAR;
+    DMA1_Channel5->CMAR = (uint32_t)&s_dma_frames[first][0];
+    DMA1_Channel5->CNDTR = (frames - first) * 3;
+    DMA1_Channel5->CCR = DMA_CCR_PL_1 | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0 | DMA_CCR_MINC |
+                         (first ? 0 : DMA_CCR_CIRC) | DMA_CCR_DIR | (half ? DMA_CCR_TCIE : 0);
+    s_dma_count = frames;
+    if (invert) {
+        TIM1->CCER ^= RGB_LED_DMA_POLARITY;
+    }
+    if (half) {
+        HAL_NVIC_SetPriority(DMA1_Channel4_5_IRQn, 1, 0);
+        HAL_NVIC_EnableIRQ(DMA1_Channel4_5_IRQn);
+    }
+
+    // 每个更新事件 burst 写3个寄存器: CCR2, CCR3, CCR4 (CCR 预装载，下一周期生效)
+    TIM1->DCR = TIM_DMABASE_CCR2 | TIM_DMABURSTLENGTH_3TRANSFERS;
+    TIM1->RCR = rcr_plus1 - 1;
+    DMA1_Channel5->CCR |= DMA_CCR_EN;
+    TIM1->DIER |= TIM_DIER_UDE;
+
+    led->dma_running = 1;
+    return 1;
+}
+
+void RGB_LED_DMA_IRQHandler(void)
+{
+    if (DMA1->ISR & DMA_ISR_TCIF5) {
+        DMA1->IFCR = DMA_IFCR_CGIF5;
+        // 半周期回放: 每播完一遍翻转输出极性，得到互补的另半个周期
+        TIM1->CCER ^= RGB_LED_DMA_POLARITY;
+        // 首圈从中途的帧开始 (单次传输)，播完后改为从第0帧开始整圈循环
+        if (!(DMA1_Channel5->CCR & DMA_CCR_CIRC)) {
+            DMA1_Channel5->CCR &= ~DMA_CCR_EN;
+            DMA1_Channel5->CMAR = (uint32_t)&s_dma_frames[0][0];
+            DMA1_Channel5->CNDTR = s_dma_count * 3;
+            DMA1_Channel5->CCR |= DMA_CCR_CIRC | DMA_CCR_EN;
+        }
+    }
 }
 
 // --- 公共函数实现 ---
 
+// 两种后端共用的状态初始化
+static void _init_state(RGB_LED_t *led, LED_Connection_t connection)
+{
+    led->connection_type = connection;
+    led->playback = LED_PLAYBACK_CPU;
+    led->dma_running = 0;
+    led->frame_interval = RGB_LED_DEFAULT_FRAME_MS;
+    led->next_frame = HAL_GetTick();
+    led->frames_rendered = 0;
+    led->ccr_writes_skipped = 0;
+
+    RGB_LED_RefreshTimebase(led);
+    _sync_compare(led);
+}
+
 void RGB_LED_Init(RGB_LED_t *led, LED_Connection_t connection,
                   TIM_HandleTypeDef *htim_r, uint32_t channel_r,
                   TIM_HandleTypeDef *htim_g, uint32_t channel_g,
                   TIM_HandleTypeDef *htim_b, uint32_t channel_b)
 {
-    led->connection_type = connection;
+    led->backend = &s_backend_tim;
     led->htim_r = htim_r;
     led->channel_r = channel_r;
     led->htim_g = htim_g;
     led->channel_g = channel_g;
     led->htim_b = htim_b;
     led->channel_b = channel_b;
+    _init_state(led, connection);
 
     // 启动所有PWM通道
     HAL_TIM_PWM_Start(led->htim_r, led->channel_r);
@@ -58,31 +649,187 @@ void RGB_LED_Init(RGB_LED_t *led, LED_Connection_t connection,
     RGB_LED_Off(led);
 }
 
+void RGB_LED_InitSoft(RGB_LED_t *led, LED_Connection_t connection,
+                      uint8_t channel_r, uint8_t channel_g, uint8_t channel_b)
+{
+    led->backend = &s_backend_soft;
+    led->htim_r = 0;
+    led->channel_r = channel_r;
+    led->htim_g = 0;
+    led->channel_g = channel_g;
+    led->htim_b = 0;
+    led->channel_b = channel_b;
+    _init_state(led, connection);
+
+    // 初始化为关闭状态
+    RGB_LED_Off(led);
+}
+
+void RGB_LED_InitWs2812(RGB_LED_t *led, uint16_t pixel)
+{
+    uint32_t base = (uint32_t)pixel * WS2812_BYTES_PER_PIXEL;
+
+    led->backend = &s_backend_ws2812;
+    led->htim_r = 0;
+    led->channel_r = base + 0;
+    led->htim_g = 0;
+    led->channel_g = base + 1;
+    led->htim_b = 0;
+    led->channel_b = base + 2;
+    // 灯珠自带 PWM，数值越大越亮
+    _init_state(led, LED_CONNECTION_COMMON_CATHODE);
+
+    // 初始化为关闭状态
+    RGB_LED_Off(led);
+}
+
+void RGB_LED_InitVirtual(RGB_LED_t *led)
+{
+    led->backend = &s_backend_none;
+    led->htim_r = 0;
+    led->channel_r = 0;
+    led->htim_g = 0;
+    led->channel_g = 0;
+    led->htim_b = 0;
+    led->channel_b = 0;
+    _init_state(led, LED_CONNECTION_COMMON_CATHODE);
+    // 由上层按需调用，每次调用都渲染
+    led->frame_interval = 1;
+
+    RGB_LED_Off(led);
+}
+
+void RGB_LED_RefreshTimebase(RGB_LED_t *led)
+{
+    uint32_t primask = Critical_Enter();
+    led->max_duty_r = led->backend->max_level(led->htim_r);
+    led->max_duty_g = led->backend->max_level(led->htim_g);
+    led->max_duty_b = led->backend->max_level(led->htim_b);
+    Critical_Exit(primask);
+}
+
+void RGB_LED_SetFrameInterval(RGB_LED_t *led, uint32_t interval_ms)
+{
+    uint32_t primask = Critical_Enter();
+    led->frame_interval = interval_ms ? interval_ms : 1;
+    Critical_Exit(primask);
+}
+
+void RGB_LED_SetPlayback(RGB_LED_t *led, LED_Playback_t playback)
+{
+    uint32_t primask = Critical_Enter();
+    _dma_stop(led);
+    led->playback = playback;
+    Critical_Exit(primask);
+
+    // 正在播放的动态效果按新方式重新启动
+    if (led->mode == LED_MODE_BREATH || led->mode == LED_MODE_FLASH) {
+        _dma_start(led);
+    }
+}
+
 void RGB_LED_SetStaticColor(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b)
 {
+    uint32_t primask = Critical_Enter();
+    _dma_stop(led);
     led->mode = LED_MODE_STATIC;
-    _set_pwm_by_color(led->htim_r, led->channel_r, r, led->connection_type);
-    _set_pwm_by_color(led->htim_g, led->channel_g, g, led->connection_type);
-    _set_pwm_by_color(led->htim_b, led->channel_b, b, led->connection_type);
+    _apply_color(led, r, g, b);
+    Critical_Exit(primask);
+}
+
+void RGB_LED_FadeTo(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b, uint32_t duration_ms)
+{
+    uint32_t primask;
+    uint32_t now;
+    uint8_t from[3];
+
+    TRACE(TRACE_LED_START, LED_MODE_FADE);
+
+    if (duration_ms == 0) {
+        RGB_LED_SetStaticColor(led, r, g, b);
+        return;
+    }
+
+    primask = Critical_Enter();
+    now = HAL_GetTick();
+    // DMA 回放时 CPU 没有输出过颜色，按时间算出此刻的颜色作为起点
+    if (led->dma_running) {
+        _render_color(led, now - led->timer_start, from);
+        _dma_stop(led);
+    } else {
+        from[0] = led->cur_r;
+        from[1] = led->cur_g;
+        from[2] = led->cur_b;
+    }
+    led->mode = LED_MODE_FADE;
+    led->prog_r = from[0];
+    led->prog_g = from[1];
+    led->prog_b = from[2];
+    led->target_r = r;
+    led->target_g = g;
+    led->target_b = b;
+    led->timer_start = now;
+    led->deadline = now + duration_ms;
+    // 每毫秒进度增量 (Q16 进度左移16位)，除法只在这里做一次
+    led->phase_step = 0xFFFFFFFFu / duration_ms;
+    led->next_frame = now;
+    Critical_Exit(primask);
+}
+
+void RGB_LED_HsvToRgb(uint16_t h, uint8_t s, uint8_t v, uint8_t rgb[3])
+{
+    uint8_t sector, f, p, q, t;
+
+    if (h >= LED_HUE_MAX) {
+        h %= LED_HUE_MAX;
+    }
+    sector = (uint8_t)(h >> 8);
+    f = (uint8_t)h; // 扇区内的位置 (0-255)
+
+    p = (uint8_t)_div255((uint32_t)v * (255 - s));
+    q = (uint8_t)_div255((uint32_t)v * (255 - _div255((uint32_t)s * f)));
+    t = (uint8_t)_div255((uint32_t)v * (255 - _div255((uint32_t)s * (255 - f))));
+
+    switch (sector)
+    {
+        case 0:  rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+        case 1:  rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+        case 2:  rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+        case 3:  rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+        case 4:  rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+        default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+    }
 }
 
 void RGB_LED_Off(RGB_LED_t *led)
 {
-    led->mode = LED_MODE_OFF;
     // 设置颜色为(0,0,0)即可关闭
     RGB_LED_SetStaticColor(led, 0, 0, 0);
+    led->mode = LED_MODE_OFF;
 }
 
 void RGB_LED_StartWhiteBreath(RGB_LED_t *led, uint32_t period_ms)
 {
+    TRACE(TRACE_LED_START, LED_MODE_BREATH);
+    uint32_t primask = Critical_Enter();
     led->mode = LED_MODE_BREATH;
     led->period = period_ms;
+    // 每毫秒的相位增量 (2^32 对应一个周期)，除法只在启动时做一次
+    led->phase_step = period_ms ? (0xFFFFFFFFu / period_ms) : 0;
     led->timer_start = HAL_GetTick();
+    led->next_frame = led->timer_start;  // 下一次 Update 立即渲染
+    _dma_stop(led);
+    Critical_Exit(primask);
+
+    // 渲染帧缓冲耗时较长，放在临界区外；其间 RGB_LED_Update 照常由 CPU 更新
+    _dma_start(led);
 }
 
 void RGB_LED_StartFlash(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b,
                        uint32_t on_time_ms, uint32_t off_time_ms)
 {
+    TRACE(TRACE_LED_START, LED_MODE_FLASH);
+    uint32_t primask = Critical_Enter();
     led->mode = LED_MODE_FLASH;
     led->target_r = r;
     led->target_g = g;
@@ -90,51 +837,122 @@ void RGB_LED_StartFlash(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b,
     led->on_time = on_time_ms;
     led->period = on_time_ms + off_time_ms;
     led->timer_start = HAL_GetTick();
+    led->next_frame = led->timer_start;  // 下一次 Update 立即渲染
+    _dma_stop(led);
+    Critical_Exit(primask);
+
+    // 渲染帧缓冲耗时较长，放在临界区外；其间 RGB_LED_Update 照常由 CPU 更新
+    _dma_start(led);
 }
 
-void RGB_LED_Update(RGB_LED_t *led)
+void RGB_LED_RunProgram(RGB_LED_t *led, const uint8_t *program)
 {
-    // 对于静态和关闭模式，PWM占空比已设定，无需更新
-    if (led->mode == LED_MODE_STATIC || led->mode == LED_MODE_OFF) {
+    TRACE(TRACE_LED_START, LED_MODE_PROGRAM);
+    uint32_t primask = Critical_Enter();
+    _dma_stop(led);
+    led->mode = LED_MODE_PROGRAM;
+    led->program = program;
+    led->pc = 0;
+    led->loop_count = 0;
+    led->ramping = 0;
+    led->prog_r = led->prog_g = led->prog_b = 0;
+    led->deadline = HAL_GetTick();
+    led->next_frame = led->deadline;     // 下一次 Update 立即执行第一条指令
+    Critical_Exit(primask);
+}
+
+// 判断 now 是否到达渲染帧并推进帧时刻
+static uint8_t _frame_due(RGB_LED_t *led, uint32_t now)
+{
+    if ((int32_t)(now - led->next_frame) < 0) {
+        return 0;
+    }
+    led->next_frame += led->frame_interval;
+    if ((int32_t)(now - led->next_frame) >= 0) {
+        // 落后一帧以上 (例如扫描定时器停过)，从当前时刻重新对齐，不补帧
+        led->next_frame = now + led->frame_interval;
+    }
+    led->frames_rendered++;
+    return 1;
+}
+
+uint8_t RGB_LED_FrameDue(RGB_LED_t *led)
+{
+    return _frame_due(led, HAL_GetTick());
+}
+
+void RGB_LED_Follow(RGB_LED_t *led, const RGB_LED_t *src)
+{
+    uint32_t primask;
+
+    // 已在播放同一效果 (同一起点)，不做任何事
+    if (led->mode == src->mode && led->timer_start == src->timer_start &&
+        led->period == src->period && led->phase_step == src->phase_step &&
+        led->on_time == src->on_time && led->target_r == src->target_r &&
+        led->target_g == src->target_g && led->target_b == src->target_b) {
         return;
     }
 
-    uint32_t elapsed_time = HAL_GetTick() - led->timer_start;
+    primask = Critical_Enter();
+    _dma_stop(led);
+    led->mode = src->mode;
+    led->target_r = src->target_r;
+    led->target_g = src->target_g;
+    led->target_b = src->target_b;
+    led->timer_start = src->timer_start;
+    led->period = src->period;
+    led->phase_step = src->phase_step;
+    led->on_time = src->on_time;
+    led->next_frame = HAL_GetTick();
+    Critical_Exit(primask);
 
-    switch (led->mode)
-    {
-        case LED_MODE_BREATH:
-        {
-            // 使用正弦函数生成平滑的亮度曲线
-            // y = (sin(x) + 1) / 2  -- 将-1~1范围映射到0~1
-            float angle = 2.0f * M_PI * (float)(elapsed_time % led->period) / (float)led->period;
-            float brightness_factor = (sinf(angle - M_PI / 2.0f) + 1.0f) / 2.0f;
-            uint8_t color_val = (uint8_t)(brightness_factor * 255.0f);
-            
-            // 白色呼吸灯，所有通道使用相同亮度
-            _set_pwm_by_color(led->htim_r, led->channel_r, color_val, led->connection_type);
-            _set_pwm_by_color(led->htim_g, led->channel_g, color_val, led->connection_type);
-            _set_pwm_by_color(led->htim_b, led->channel_b, color_val, led->connection_type);
-            break;
-        }
+    // 沿用源效果的 timer_start，DMA 从当前相位开始回放: 上层图层到期后恢复的下层不会跳回周期起点
+    _dma_start(led);
+}
 
-        case LED_MODE_FLASH:
-        {
-            if ((elapsed_time % led->period) < led->on_time) {
-                // 亮灯时间
-                _set_pwm_by_color(led->htim_r, led->channel_r, led->target_r, led->connection_type);
-                _set_pwm_by_color(led->htim_g, led->channel_g, led->target_g, led->connection_type);
-                _set_pwm_by_color(led->htim_b, led->channel_b, led->target_b, led->connection_type);
-            } else {
-                // 灭灯时间
-                _set_pwm_by_color(led->htim_r, led->channel_r, 0, led->connection_type);
-                _set_pwm_by_color(led->htim_g, led->channel_g, 0, led->connection_type);
-                _set_pwm_by_color(led->htim_b, led->channel_b, 0, led->connection_type);
-            }
-            break;
-        }
+static void _update(RGB_LED_t *led)
+{
+    uint32_t now;
+    uint8_t rgb[3];
 
-        default:
-            break;
+    // 对于静态和关闭模式，PWM占空比已设定，无需更新；DMA 回放时由硬件写 CCR
+    if (led->mode == LED_MODE_STATIC || led->mode == LED_MODE_OFF || led->dma_running) {
+        return;
+    }
+
+    // 非渲染帧直接返回
+    now = HAL_GetTick();
+    if (!_frame_due(led, now)) {
+        return;
+    }
+
+    if (led->mode == LED_MODE_PROGRAM) {
+        _program_run(led, now);
+        return;
+    }
+    if (led->mode == LED_MODE_FADE) {
+        _fade_run(led, now);
+        return;
     }
+
+    if (led->mode == LED_MODE_BREATH) {
+        _apply_level(led, _breath_level_q16(led, now - led->timer_start));
+        return;
+    }
+    _render_color(led, now - led->timer_start, rgb);
+    _apply_color(led, rgb[0], rgb[1], rgb[2]);
+}
+
+void RGB_LED_Update(RGB_LED_t *led)
+{
+    PROF_ENTER(PROF_LED_UPDATE);
+    _update(led);
+    PROF_EXIT(PROF_LED_UPDATE);
+}
+
+uint8_t RGB_LED_IsAnimating(const RGB_LED_t *led)
+{
+    // DMA 回放不需要 CPU 周期更新
+    return (led->mode == LED_MODE_BREATH || led->mode == LED_MODE_FLASH ||
+            led->mode == LED_MODE_PROGRAM || led->mode == LED_MODE_FADE) && !led->dma_running;
 }
@@ -27,12 +27,98 @@ typedef enum {
     LED_MODE_OFF,
     LED_MODE_STATIC,
     LED_MODE_BREATH,
-    LED_MODE_FLASH
+    LED_MODE_FLASH,
+    LED_MODE_PROGRAM,   // 运行 Flash 中的效果程序，见下方操作码定义
+    LED_MODE_FADE       // 渐变到目标颜色，结束后转为 LED_MODE_STATIC
 } LED_Mode_t;
 
+// --- HSV 色相 ---
+// 色相范围 0 ~ LED_HUE_MAX-1，每 256 为一个60度扇区，换算只用移位和乘法
+#define LED_HUE_MAX      1536
+#define LED_HUE_RED      0
+#define LED_HUE_YELLOW   256
+#define LED_HUE_GREEN    512
+#define LED_HUE_CYAN     768
+#define LED_HUE_BLUE     1024
+#define LED_HUE_MAGENTA  1280
+
+
+// --- 动态效果回放方式 ---
+typedef enum {
+    LED_PLAYBACK_CPU,       // 由 RGB_LED_Update 周期计算并写 CCR (默认)
+    LED_PLAYBACK_DMA,       // 预渲染一个周期，TIM1 更新事件触发 DMA burst 循环写 CCR2~4，CPU 零参与
+    LED_PLAYBACK_DMA_HALF   // 呼吸只渲染半个周期，另一半靠翻转输出极性得到，RAM 减半
+} LED_Playback_t;
+
+// DMA 回放缓冲区帧数 (每帧6字节)。DMA 的帧间隔不超过 LED 的帧间隔 (RGB_LED_SetFrameInterval)，
+// 默认 10ms 帧间隔下只回放周期不超过 640ms 的效果，更长的周期退回 CPU 更新
+#ifndef RGB_LED_DMA_MAX_FRAMES
+#define RGB_LED_DMA_MAX_FRAMES   64
+#endif
+
+// --- 效果程序 (LED_MODE_PROGRAM) ---
+// 效果以字节码形式写成 const uint8_t 数组放在 Flash 中，由 RGB_LED_Update 逐条解释:
+// 只有当前指令的截止时刻到达时才取下一条指令，保持期间每 tick 只做一次时间比较，
+// 渐变期间每 tick 做一次插值。时长为16位毫秒，跳转目标为程序内的字节偏移 (程序不超过256字节)。
+typedef enum {
+    LED_OP_END  = 0x00, // 结束，保持最后的颜色 (转为 LED_MODE_STATIC)
+    LED_OP_SET  = 0x01, // SET  r g b          立即设置颜色
+    LED_OP_RAMP = 0x02, // RAMP ms_lo ms_hi r g b  在 ms 毫秒内从当前颜色线性渐变到目标颜色
+    LED_OP_HOLD = 0x03, // HOLD ms_lo ms_hi    保持当前颜色 ms 毫秒
+    LED_OP_LOOP = 0x04, // LOOP n target       跳回 target，使循环体共执行 n 次 (单层，不可嵌套)
+    LED_OP_JUMP = 0x05  // JUMP target         无条件跳转，用于无限循环
+} LED_Opcode_t;
+
+// 指令编写宏，颜色参数可直接使用上面的 COLOR_xxx 宏，例如:
+//   static const uint8_t blink_then_breathe[] = {
+//       LED_SET(COLOR_RED),                 // 偏移 0
+//       LED_HOLD(100), LED_SET(COLOR_OFF),  // 偏移 4, 7
+//       LED_HOLD(100), LED_LOOP(3, 0),      // 偏移 11, 14: 红色闪3次
+//       LED_RAMP(1000, COLOR_WHITE),        // 偏移 17
+//       LED_RAMP(1000, COLOR_OFF),          // 偏移 23
+//       LED_JUMP(17),                       // 偏移 29: 之后一直呼吸
+//   };
+#define LED_U16(ms)            (uint8_t)((ms) & 0xFF), (uint8_t)(((ms) >> 8) & 0xFF)
+#define LED_SET(...)           LED_OP_SET, __VA_ARGS__
+#define LED_RAMP(ms, ...)      LED_OP_RAMP, LED_U16(ms), __VA_ARGS__
+#define LED_HOLD(ms)           LED_OP_HOLD, LED_U16(ms)
+#define LED_LOOP(n, target)    LED_OP_LOOP, (uint8_t)(n), (uint8_t)(target)
+#define LED_JUMP(target)       LED_OP_JUMP, (uint8_t)(target)
+#define LED_END()              LED_OP_END
+
+// 各指令长度 (字节)，用于计算跳转偏移
+#define LED_SET_LEN    4
+#define LED_RAMP_LEN   6
+#define LED_HOLD_LEN   3
+#define LED_LOOP_LEN   3
+#define LED_JUMP_LEN   2
+#define LED_END_LEN    1
+
+// 默认渲染帧间隔 (ms)，RGB_LED_Update 可以更高频率调用，非渲染帧直接返回
+#ifndef RGB_LED_DEFAULT_FRAME_MS
+#define RGB_LED_DEFAULT_FRAME_MS    10
+#endif
+
+// 单次 RGB_LED_Update 最多执行的指令数，防止没有时长的死循环 (如 JUMP 到自身) 卡住中断
+#ifndef RGB_LED_PROGRAM_MAX_STEPS
+#define RGB_LED_PROGRAM_MAX_STEPS   8
+#endif
+
+// --- 输出后端 ---
+// 比较值的写入方式: 硬件定时器PWM (RGB_LED_Init)、GPIO 软件PWM (RGB_LED_InitSoft，见 soft_pwm.h)
+// 或 WS2812 灯带 (RGB_LED_InitWs2812，见 ws2812.h)
+// 后两种后端中 htim 为 0，channel 为 SoftPWM 通道号或 WS2812 颜色通道号
+typedef struct {
+    void     (*write)(TIM_HandleTypeDef *htim, uint32_t channel, uint16_t value); // 写一个通道的比较值
+    uint16_t (*read)(TIM_HandleTypeDef *htim, uint32_t channel);                  // 读回当前比较值
+    uint16_t (*max_level)(TIM_HandleTypeDef *htim);                              // 满量程 (PWM 的 ARR)
+    void     (*flush)(void);  // 一次颜色更新写完后调用，不需要时为 0
+} RGB_LED_Backend_t;
 
 // --- RGB LED 结构体 (已修改) ---
 typedef struct {
+    const RGB_LED_Backend_t *backend;
+
     // 硬件PWM配置
     TIM_HandleTypeDef *htim_r;    // R通道的定时器句柄
     uint32_t           channel_r; // R通道的定时器通道 (例如: TIM_CHANNEL_1)
@@ -40,21 +126,59 @@ typedef struct {
     uint32_t           channel_g; // G通道的定时器通道
     TIM_HandleTypeDef *htim_b;    // B通道的定时器句柄
     uint32_t           channel_b; // B通道的定时器通道
+
+    // 各通道定时器的 ARR 缓存 (PWM满量程)，ARR 改变后调用 RGB_LED_RefreshTimebase 更新
+    uint16_t max_duty_r;
+    uint16_t max_duty_g;
+    uint16_t max_duty_b;
     
+    // 最近一次写入各通道的比较值，相同则不再写 CCR
+    uint16_t ccr_r;
+    uint16_t ccr_g;
+    uint16_t ccr_b;
+
     // LED连接方式
     LED_Connection_t connection_type; 
 
     // 当前模式
     LED_Mode_t mode;
 
+    // 回放方式
+    LED_Playback_t playback;
+    uint8_t        dma_running; // DMA 回放进行中
+
     // 动态效果的状态参数
     uint8_t  target_r;    // 闪烁模式的目标颜色
     uint8_t  target_g;
     uint8_t  target_b;
     uint32_t timer_start; // 通用计时器起点
     uint32_t period;      // 呼吸或闪烁的总周期
+    uint32_t phase_step;  // 呼吸每毫秒的相位增量 (2^32 为一个周期)
     uint32_t on_time;     // 闪烁的亮灯时间
 
+    // 帧率控制
+    uint32_t frame_interval; // 渲染帧间隔 (ms)
+    uint32_t next_frame;     // 下一帧的渲染时刻 (HAL_GetTick)
+
+    // 统计计数 (只增不减，按32位回绕)
+    uint32_t frames_rendered;    // 已渲染的帧数
+    uint32_t ccr_writes_skipped; // 因比较值未变化而省去的 CCR 写入次数
+
+    // 效果程序解释器状态 (渐变复用 target_x / timer_start / phase_step)
+    const uint8_t *program;  // 程序首地址 (Flash)
+    uint32_t deadline;       // 当前指令的截止时刻 (HAL_GetTick)
+    uint8_t  pc;             // 下一条指令的字节偏移
+    uint8_t  loop_count;     // LOOP 剩余次数，0 表示不在循环中
+    uint8_t  ramping;        // 当前指令为 RAMP
+    uint8_t  prog_r;         // 程序当前颜色 (渐变起点，淡入淡出共用)
+    uint8_t  prog_g;
+    uint8_t  prog_b;
+
+    // 最近一次输出的颜色 (CPU 更新)，作为淡入淡出的起点
+    uint8_t  cur_r;
+    uint8_t  cur_g;
+    uint8_t  cur_b;
+
 } RGB_LED_t;
 
 /**
@@ -75,13 +199,91 @@ void RGB_LED_Init(RGB_LED_t *led, LED_Connection_t connection,
                   TIM_HandleTypeDef *htim_g, uint32_t channel_g,
                   TIM_HandleTypeDef *htim_b, uint32_t channel_b);
 
+/**
+ * @brief 用 GPIO 软件PWM (BCM) 通道驱动RGB LED，接口与硬件PWM完全相同
+ * @param led 指向RGB_LED_t结构体的指针
+ * @param connection LED的连接方式 (共阴/共阳)
+ * @param channel_r, channel_g, channel_b 各颜色对应的 SoftPWM 通道号
+ * @note  须先调用 SoftPWM_Init。亮度分辨率为 SOFT_PWM_BITS 位，不支持 DMA 回放。
+ */
+void RGB_LED_InitSoft(RGB_LED_t *led, LED_Connection_t connection,
+                      uint8_t channel_r, uint8_t channel_g, uint8_t channel_b);
+
+/**
+ * @brief 把 WS2812 灯带上的一颗像素作为RGB LED 驱动，接口与硬件PWM完全相同
+ * @param led 指向RGB_LED_t结构体的指针
+ * @param pixel 像素序号
+ * @note  须先调用 WS2812_Init。每个像素一个 RGB_LED_t，颜色有变化的帧才刷新灯带；
+ *        不支持 DMA 回放 (LED_PLAYBACK_DMA 自动退回 CPU 更新)。
+ */
+void RGB_LED_InitWs2812(RGB_LED_t *led, uint16_t pixel);
+
+/**
+ * @brief 初始化一个不驱动硬件的虚拟 LED
+ * @param led 指向RGB_LED_t结构体的指针
+ * @note  所有效果照常运行，每次 RGB_LED_Update 都渲染一帧，结果保存在 cur_r/cur_g/cur_b，
+ *        用作合成器的图层 (见 led_compositor.h)。
+ */
+void RGB_LED_InitVirtual(RGB_LED_t *led);
+
+/**
+ * @brief 重新读取各通道定时器的 ARR
+ * @param led 指向RGB_LED_t结构体的指针
+ * @note  颜色值经 CIE 明度表映射为 0~ARR 的比较值，ARR 只在初始化时读取一次；
+ *        运行中修改了PWM定时器的 ARR 后需调用此函数。
+ */
+void RGB_LED_RefreshTimebase(RGB_LED_t *led);
+
+/**
+ * @brief 设置动态效果的渲染帧间隔
+ * @param led 指向RGB_LED_t结构体的指针
+ * @param interval_ms 帧间隔 (ms)，例如 10 即 100Hz；0 按 1 处理
+ * @note  RGB_LED_Update 的调用频率可以高于帧率，非渲染帧只做一次时间比较即返回。
+ */
+void RGB_LED_SetFrameInterval(RGB_LED_t *led, uint32_t interval_ms);
+
+/**
+ * @brief 选择动态效果 (呼吸/闪烁) 的回放方式
+ * @param led 指向RGB_LED_t结构体的指针
+ * @param playback 回放方式
+ * @note  DMA 回放要求 R/G/B 分别接在 TIM1 的 CH2/CH3/CH4 (占用 DMA1 通道5)，
+ *        效果周期是整数个 PWM 周期 (能按整数帧循环)，且 RGB_LED_DMA_MAX_FRAMES 帧放得下、
+ *        帧间隔不超过 LED 的帧间隔 (在效果启动时判断)，否则自动退回 CPU 更新。
+ *        整个模块同一时间只有一个 LED 可使用 DMA 回放。
+ */
+void RGB_LED_SetPlayback(RGB_LED_t *led, LED_Playback_t playback);
+
+/**
+ * @brief DMA1 通道4/5 中断处理，在 DMA1_Channel4_5_IRQHandler 中调用
+ */
+void RGB_LED_DMA_IRQHandler(void);
+
 /**
  * @brief 设置LED为常亮颜色
  * @param led 指向RGB_LED_t结构体的指针
- * @param r, g, b 8位的RGB颜色值 (0-255)
+ * @param r, g, b 8位的RGB颜色值 (0-255)，按感知亮度处理 (经CIE明度校正)
  */
 void RGB_LED_SetStaticColor(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b);
 
+/**
+ * @brief 从当前颜色渐变到目标颜色
+ * @param led 指向RGB_LED_t结构体的指针
+ * @param r, g, b 目标颜色 (0-255)
+ * @param duration_ms 渐变时长 (ms)，0 等同于 RGB_LED_SetStaticColor
+ * @note  每渲染一帧用 Q16 定点线性插值，除法只在启动时做一次；
+ *        结束后保持目标颜色 (LED_MODE_STATIC)。
+ */
+void RGB_LED_FadeTo(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b, uint32_t duration_ms);
+
+/**
+ * @brief HSV 转 RGB，纯整数运算
+ * @param h 色相 (0 ~ LED_HUE_MAX-1)，超出范围按 LED_HUE_MAX 取模
+ * @param s 饱和度 (0-255)
+ * @param v 明度 (0-255)
+ * @param rgb 输出的颜色值 (0-255)
+ */
+void RGB_LED_HsvToRgb(uint16_t h, uint8_t s, uint8_t v, uint8_t rgb[3]);
+
 /**
  * @brief 关闭LED
  * @param led 指向RGB_LED_t结构体的指针
@@ -106,10 +308,38 @@ void RGB_LED_StartFlash(RGB_LED_t *led, uint8_t r, uint8_t g, uint8_t b,
                        uint32_t on_time_ms, uint32_t off_time_ms);
 
 /**
- * @brief 更新LED状态，实现动态效果 (呼吸/闪烁)
- * @note  此函数不再需要高频调用。放在主循环的 while(1) 中即可。
- *        例如每10-20ms调用一次，足以保证动画平滑。
+ * @brief 运行效果程序
+ * @param led 指向RGB_LED_t结构体的指针
+ * @param program 字节码程序 (const 数组，放在 Flash 中)，以 LED_OP_END 结束或以 JUMP 无限循环
+ * @note  程序从黑色开始，第一条指令在下一次 RGB_LED_Update 时执行；
+ *        效果程序总是由 CPU 更新，不使用 DMA 回放。
+ */
+void RGB_LED_RunProgram(RGB_LED_t *led, const uint8_t *program);
+
+/**
+ * @brief 更新LED状态，实现动态效果 (呼吸/闪烁/效果程序/渐变)
+ * @note  可在 1ms 定时中断或主循环中调用，只在到达帧间隔时渲染一帧，
+ *        每帧计算一次比较值，只写入与上次不同的通道。
  */
 void RGB_LED_Update(RGB_LED_t *led);
 
+/**
+ * @brief 判断是否到达该 LED 的下一个渲染帧，到达时推进帧时刻并计数
+ * @note  供驱动该 LED 的上层 (如合成器) 按同一帧率渲染
+ */
+uint8_t RGB_LED_FrameDue(RGB_LED_t *led);
+
+/**
+ * @brief 让 led 播放与 src 相同的呼吸/闪烁效果 (同一时间起点，相位一致)
+ * @note  效果参数相同时直接返回；否则按 led 的回放方式重新启动，可使用 DMA 回放。
+ *        只复制呼吸/闪烁参数，src 通常是合成器中的虚拟 LED。
+ */
+void RGB_LED_Follow(RGB_LED_t *led, const RGB_LED_t *src);
+
+/**
+ * @brief 判断LED当前是否处于需要周期更新的动态效果 (呼吸/闪烁/效果程序/渐变)
+ * @return 1: 需要周期调用 RGB_LED_Update; 0: 静态、关闭或 DMA 回放中
+ */
+uint8_t RGB_LED_IsAnimating(const RGB_LED_t *led);
+
 #endif
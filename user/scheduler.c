@@ -0,0 +1,99 @@
+/* === C代码文件: scheduler.c === */
+#include "scheduler.h"
+
+// SysTick 为 24 位递减计数器，差值按重装值回绕
+static inline uint32_t _cycles_since(uint32_t start)
+{
+    uint32_t now = SysTick->VAL;
+    return (start >= now) ? (start - now) : (start + SysTick->LOAD + 1 - now);
+}
+
+void Sched_Init(Sched_t *s, const Sched_Task_t *tasks, Sched_TaskStats_t *stats, uint8_t count)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t i;
+
+    s->tasks = tasks;
+    s->stats = stats;
+    s->count = count;
+    s->worst_tick_cycles = 0;
+    s->deferred = 0;
+    for (i = 0; i < count; i++) {
+        stats[i].next_run = now + tasks[i].offset;
+        stats[i].runs = 0;
+        stats[i].worst_cycles = 0;
+        stats[i].avg_cycles_q4 = 0;
+    }
+}
+
+void Sched_Tick(Sched_t *s)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t tick_start = SysTick->VAL;
+    uint32_t tick_cycles;
+    uint8_t i, ran = 0;
+
+    for (i = 0; i < s->count; i++) {
+        const Sched_Task_t *task = &s->tasks[i];
+        Sched_TaskStats_t *st = &s->stats[i];
+        uint32_t start, cycles;
+
+        if ((int32_t)(now - st->next_run) < 0) {
+            continue;
+        }
+        if (ran >= SCHED_MAX_RUNS_PER_TICK) {
+            s->deferred++; // 仍保持到期状态，下一个 tick 执行
+            continue;
+        }
+
+        st->next_run += task->period;
+        if ((int32_t)(now - st->next_run) >= 0) {
+            // 落后一个周期以上 (例如定时器停过)，按偏移重新错开，不补执行
+            st->next_run = now + task->period + task->offset;
+        }
+
+        start = SysTick->VAL;
+        task->run(task->arg);
+        cycles = _cycles_since(start);
+        ran++;
+
+        st->runs++;
+        if (cycles > st->worst_cycles) {
+            st->worst_cycles = cycles;
+        }
+        // avg += (sample - avg) / 16
+        st->avg_cycles_q4 += cycles - (st->avg_cycles_q4 >> 4);
+    }
+
+    if (ran) {
+        tick_cycles = _cycles_since(tick_start);
+        if (tick_cycles > s->worst_tick_cycles) {
+            s->worst_tick_cycles = tick_cycles;
+        }
+    }
+}
+
+uint32_t Sched_NextDeadline(Sched_t *s)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t next = UINT32_MAX;
+    uint8_t i;
+
+    for (i = 0; i < s->count && next; i++) {
+        const Sched_Task_t *task = &s->tasks[i];
+        int32_t until_run = (int32_t)(s->stats[i].next_run - now);
+        uint32_t wait = until_run > 0 ? (uint32_t)until_run : 0;
+
+        // 任务暂时无事可做时，等到它给出的时刻 (之后的第一个周期点或立即执行)
+        if (task->idle) {
+            uint32_t idle = task->idle(task->arg);
+            if (idle > wait) {
+                wait = idle;
+            }
+        }
+        if (wait < next) {
+            next = wait;
+        }
+    }
+    return next;
+}
@@ -0,0 +1,66 @@
+/* === C/C++ Header代码文件: scheduler.h === */
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 协作式节拍调度器
+//
+// 任务表为 const 数组 (Flash)，每个任务有自己的周期和相位偏移，
+// Sched_Tick 在 1ms 节拍 (定时中断或由它投递事件的内核任务) 中调用，只执行到期的任务。
+// 不同任务取不同的偏移错开执行时刻，单个 tick 的工作量不会叠加；
+// 每 tick 最多执行 SCHED_MAX_RUNS_PER_TICK 个任务，其余顺延到下一个 tick，中断耗时有上限。
+// 新增模块只需在任务表中加一行，不必修改中断函数。
+
+#ifndef SCHED_MAX_RUNS_PER_TICK
+#define SCHED_MAX_RUNS_PER_TICK   2
+#endif
+
+typedef struct {
+    void (*run)(void *arg);
+    void *arg;
+    uint16_t period;  // 执行周期 (ms)
+    uint16_t offset;  // 相位偏移 (ms)，第一次在 Sched_Init 后 offset 毫秒执行
+    // 可选: 返回任务距离下次真正有事可做的毫秒数 (0 表示按周期执行，UINT32_MAX 表示无需定时执行)，
+    // 供 Sched_NextDeadline 计算空闲时长；为 0 时任务总是按周期执行。
+    // 只做查询、不能改动外设或状态: 每轮主循环都会调用，之后不一定真的休眠
+    uint32_t (*idle)(void *arg);
+} Sched_Task_t;
+
+// 任务运行状态与耗时统计 (RAM)，与任务表一一对应
+// 耗时以 CPU 周期计，由 SysTick 计数值换算，单次执行须短于一个 SysTick 周期 (1ms)
+typedef struct {
+    uint32_t next_run;        // 下次执行时刻 (HAL_GetTick)
+    uint32_t runs;            // 执行次数
+    uint32_t worst_cycles;    // 最长一次耗时
+    uint32_t avg_cycles_q4;   // 平均耗时 (指数滑动平均，权重 1/16，Q4 定点)
+} Sched_TaskStats_t;
+
+typedef struct {
+    const Sched_Task_t *tasks;
+    Sched_TaskStats_t *stats;
+    uint8_t count;
+    uint32_t worst_tick_cycles; // 单个 tick 内所有任务的最长总耗时
+    uint32_t deferred;          // 因单 tick 执行数上限被顺延的次数
+} Sched_t;
+
+void Sched_Init(Sched_t *s, const Sched_Task_t *tasks, Sched_TaskStats_t *stats, uint8_t count);
+
+// 每 1ms 调用一次；在可被抢占的内核任务中调用时，耗时统计包含被抢占的时间
+void Sched_Tick(Sched_t *s);
+
+/**
+ * @brief 距离下一个任务需要执行的毫秒数，用于无节拍空闲
+ * @return 0: 下一个 tick 就有任务到期; UINT32_MAX: 所有任务都无需定时执行
+ * @note  会调用各任务的 idle 回调 (纯查询)，应在关中断状态下调用，休眠前需要打开的唤醒源由调用者处理
+ */
+uint32_t Sched_NextDeadline(Sched_t *s);
+
+// 任务的平均耗时 (CPU 周期)
+static inline uint32_t Sched_AverageCycles(const Sched_t *s, uint8_t index)
+{
+    return s->stats[index].avg_cycles_q4 >> 4;
+}
+
+#endif
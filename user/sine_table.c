@@ -0,0 +1,15 @@
+/* === C代码文件: sine_table.c (由 tools/gen_sine_table.py 生成，请勿手改) === */
+#include "sine_table.h"
+
+// sin(0 ~ pi/2)，Q15 格式，共 SINE_QUARTER_STEPS + 1 项
+const int16_t sine_q15_quarter[SINE_QUARTER_STEPS + 1] = {
+         0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+      6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+     12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+     18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+     23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+     27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+     30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+     32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+     32767,
+};
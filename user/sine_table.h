@@ -0,0 +1,12 @@
+/* === C/C++ Header代码文件: sine_table.h === */
+#ifndef __SINE_TABLE_H
+#define __SINE_TABLE_H
+
+#include <stdint.h>
+
+// 四分之一周期正弦表，由 tools/gen_sine_table.py 生成，位于 Flash
+#define SINE_QUARTER_STEPS   64
+
+extern const int16_t sine_q15_quarter[SINE_QUARTER_STEPS + 1];
+
+#endif
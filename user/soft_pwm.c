@@ -0,0 +1,158 @@
+/* === C代码文件: soft_pwm.c === */
+#include "soft_pwm.h"
+#include "critical.h"
+
+// 最高位平面的时长要放得进 TIM14 的16位 ARR
+_Static_assert(((uint32_t)SOFT_PWM_BASE_TICKS << (SOFT_PWM_BITS - 1)) <= 0x10000u,
+               "SOFT_PWM_BASE_TICKS << (SOFT_PWM_BITS - 1) exceeds the 16-bit ARR");
+
+// 位平面缓冲区: [缓冲区][位平面][端口] 的 BSRR 字，高16位清零、低16位置位
+static uint32_t s_planes[2][SOFT_PWM_BITS][SOFT_PWM_MAX_PORTS];
+
+static const SoftPWM_Pin_t *s_pins;
+static uint8_t  s_count;
+static uint8_t  s_port_index[SOFT_PWM_MAX_CHANNELS]; // 各通道所在端口在 s_ports 中的下标
+static GPIO_TypeDef *s_ports[SOFT_PWM_MAX_PORTS];
+static uint8_t  s_port_count;
+static uint16_t s_level[SOFT_PWM_MAX_CHANNELS];
+
+static volatile uint8_t s_front;        // 中断正在输出的缓冲区
+static volatile uint8_t s_swap_pending; // 后台缓冲区已重建完成，等待帧边界交换
+static volatile uint8_t s_flushing;     // SoftPWM_Flush 正在重建后台缓冲区
+static volatile uint8_t s_flush_again;  // 重建期间又有调用者请求刷新
+static uint8_t s_plane;                 // 下一个要输出的位平面
+
+uint8_t SoftPWM_Init(const SoftPWM_Pin_t *pins, uint8_t count)
+{
+    uint8_t i, p;
+
+    if (count > SOFT_PWM_MAX_CHANNELS) {
+        return 0;
+    }
+
+    s_pins = pins;
+    s_count = count;
+    s_port_count = 0;
+    for (i = 0; i < count; i++) {
+        for (p = 0; p < s_port_count && s_ports[p] != pins[i].port; p++) {
+        }
+        if (p == s_port_count) {
+            if (s_port_count == SOFT_PWM_MAX_PORTS) {
+                return 0;
+            }
+            s_ports[s_port_count++] = pins[i].port;
+        }
+        s_port_index[i] = p;
+        s_level[i] = 0;
+    }
+
+    // 全灭的位平面写入后台缓冲区，第一个帧边界即换到前台
+    s_front = 0;
+    s_plane = 0;
+    SoftPWM_Flush();
+    for (p = 0; p < s_port_count; p++) {
+        s_ports[p]->BSRR = s_planes[1][0][p];
+    }
+
+    // TIM14 计数频率 1MHz，ARR 预装载: 中断里写入的是下一个位平面的时长
+    __HAL_RCC_TIM14_CLK_ENABLE();
+    TIM14->CR1 = TIM_CR1_ARPE;
+    TIM14->PSC = HAL_RCC_GetPCLK1Freq() / 1000000u - 1;
+    TIM14->ARR = SOFT_PWM_BASE_TICKS - 1;
+    TIM14->EGR = TIM_EGR_UG;
+    TIM14->SR = ~TIM_SR_UIF;
+    TIM14->DIER = TIM_DIER_UIE;
+    HAL_NVIC_SetPriority(TIM14_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM14_IRQn);
+    TIM14->CR1 |= TIM_CR1_CEN;
+    return 1;
+}
+
+void SoftPWM_Set(uint8_t channel, uint16_t level)
+{
+    if (channel < s_count) {
+        s_level[channel] = level > SOFT_PWM_MAX_LEVEL ? SOFT_PWM_MAX_LEVEL : level;
+    }
+}
+
+uint16_t SoftPWM_Get(uint8_t channel)
+{
+    return channel < s_count ? s_level[channel] : 0;
+}
+
+void SoftPWM_Flush(void)
+{
+    uint32_t (*back)[SOFT_PWM_MAX_PORTS];
+    uint32_t primask;
+    uint8_t i, k, p;
+
+    // 后台缓冲区同一时间只能由一个调用者重建: 抢占了正在重建的调用者时只留下标记，
+    // 由被抢占的那次按最新的占空比重新构建后一起发布
+    primask = Critical_Enter();
+    if (s_flushing) {
+        s_flush_again = 1;
+        Critical_Exit(primask);
+        return;
+    }
+    s_flushing = 1;
+    Critical_Exit(primask);
+
+    // 先撤销交换请求，重建期间中断不会换到写了一半的缓冲区；
+    // 撤销后中断只读前台缓冲区，后台缓冲区归本函数独占
+    s_swap_pending = 0;
+    __DMB();
+    back = s_planes[s_front ^ 1];
+
+    for (;;) {
+        s_flush_again = 0;
+        for (k = 0; k < SOFT_PWM_BITS; k++) {
+            for (p = 0; p < s_port_count; p++) {
+                back[k][p] = 0;
+            }
+        }
+        for (i = 0; i < s_count; i++) {
+            uint32_t set = s_pins[i].pin;
+            uint32_t reset = (uint32_t)s_pins[i].pin << 16;
+            uint16_t level = s_level[i];
+            uint32_t *word = &back[0][s_port_index[i]];
+
+            for (k = 0; k < SOFT_PWM_BITS; k++, level >>= 1, word += SOFT_PWM_MAX_PORTS) {
+                *word |= (level & 1u) ? set : reset;
+            }
+        }
+
+        // 重建期间没有新的请求才发布，发布与清除 s_flushing 之间不能再被插入请求
+        primask = Critical_Enter();
+        if (!s_flush_again) {
+            __DMB(); // 缓冲区写完后再发布
+            s_swap_pending = 1;
+            s_flushing = 0;
+            Critical_Exit(primask);
+            return;
+        }
+        Critical_Exit(primask);
+    }
+}
+
+void SoftPWM_IRQHandler(void)
+{
+    const uint32_t *plane;
+    uint8_t p;
+
+    TIM14->SR = ~TIM_SR_UIF;
+
+    // 只在帧边界交换缓冲区，一帧内的位平面总是来自同一份数据
+    if (s_plane == 0 && s_swap_pending) {
+        s_front ^= 1;
+        s_swap_pending = 0;
+    }
+
+    plane = s_planes[s_front][s_plane];
+    for (p = 0; p < s_port_count; p++) {
+        s_ports[p]->BSRR = plane[p];
+    }
+
+    // 本位平面的时长已在上一次中断写入预装载，这里写下一个位平面的时长
+    s_plane = (s_plane + 1) % SOFT_PWM_BITS;
+    TIM14->ARR = ((uint32_t)SOFT_PWM_BASE_TICKS << s_plane) - 1;
+}
@@ -0,0 +1,63 @@
+/* === C/C++ Header代码文件: soft_pwm.h === */
+#ifndef __SOFT_PWM_H
+#define __SOFT_PWM_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 二进制码调制 (BCM) 软件PWM，用普通 GPIO 驱动多路指示灯
+//
+// 亮度的第 k 位 (位平面 k) 持续 SOFT_PWM_BASE_TICKS << k 个定时器计数，
+// 每个位平面为每个端口预先算好一个 BSRR 字，中断里只需逐端口写一次 BSRR。
+// 每帧固定 SOFT_PWM_BITS 次中断，与通道数和亮度级数无关。
+// 定时器固定使用 TIM14 (1MHz 计数)，在 TIM14_IRQHandler 中调用 SoftPWM_IRQHandler。
+// 引脚须由外部配置为推挽输出 (例如在CubeMX中配置)。
+
+#ifndef SOFT_PWM_BITS
+#define SOFT_PWM_BITS          8     // 亮度位数 (位平面数)，每帧中断次数
+#endif
+#ifndef SOFT_PWM_BASE_TICKS
+#define SOFT_PWM_BASE_TICKS    16    // 最低位平面时长 (us)，帧长 = BASE * (2^BITS - 1)，默认约 245Hz
+#endif
+#ifndef SOFT_PWM_MAX_CHANNELS
+#define SOFT_PWM_MAX_CHANNELS  16
+#endif
+#ifndef SOFT_PWM_MAX_PORTS
+#define SOFT_PWM_MAX_PORTS     2     // 引脚可分布的 GPIO 端口数
+#endif
+
+#define SOFT_PWM_MAX_LEVEL     ((1u << SOFT_PWM_BITS) - 1)
+
+// 通道描述符，定义为 const 表放在 Flash 中，表下标即通道号
+typedef struct {
+    GPIO_TypeDef *port;
+    uint16_t pin;
+} SoftPWM_Pin_t;
+
+/**
+ * @brief 绑定通道表并启动 TIM14，所有通道初始为灭 (输出低电平)
+ * @return 1: 成功; 0: 通道数或端口数超出上限
+ */
+uint8_t SoftPWM_Init(const SoftPWM_Pin_t *pins, uint8_t count);
+
+/**
+ * @brief 设置一个通道的占空比 (0 ~ SOFT_PWM_MAX_LEVEL，高电平时间)
+ * @note  只修改缓存，调用 SoftPWM_Flush 后从下一帧开始生效
+ */
+void SoftPWM_Set(uint8_t channel, uint16_t level);
+
+uint16_t SoftPWM_Get(uint8_t channel);
+
+/**
+ * @brief 由各通道占空比重建后台位平面缓冲区，在帧边界与前台缓冲区交换
+ * @note  可在主循环、内核任务或任意优先级的中断中调用，与 SoftPWM_IRQHandler 之间无需关中断。
+ *        多个上下文互相抢占时只有最先进入的调用者重建缓冲区，抢占者的修改在它完成时一起生效
+ */
+void SoftPWM_Flush(void);
+
+/**
+ * @brief TIM14 中断处理，在 TIM14_IRQHandler 中调用
+ */
+void SoftPWM_IRQHandler(void);
+
+#endif
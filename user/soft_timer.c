@@ -0,0 +1,280 @@
+/* === C代码文件: soft_timer.c === */
+#include "soft_timer.h"
+#include "critical.h"
+#include "profiler.h"
+
+#define WHEEL_BITS    5
+#define WHEEL_SLOTS   (1u << WHEEL_BITS)   // 每层槽位数，占用位图正好一个 uint32_t
+#define WHEEL_MASK    (WHEEL_SLOTS - 1u)
+#define WHEEL_SPAN    (1uL << (WHEEL_BITS * SOFT_TIMER_LEVELS)) // 时间轮范围 (ms)
+#define SLOT_NONE     0xFFu                // 节点未挂在时间轮上
+
+// 节点号和槽位号都存为单字节
+_Static_assert(SOFT_TIMER_POOL_SIZE < 255, "node ids are stored as uint8_t");
+_Static_assert(SOFT_TIMER_LEVELS * WHEEL_SLOTS < SLOT_NONE, "slot ids are stored as uint8_t");
+
+typedef struct {
+    SoftTimer_Callback_t cb;
+    void *arg;
+    uint32_t expire;  // 到期时刻 (HAL_GetTick)
+    uint16_t period;  // 重复周期，0 为单次
+    uint8_t next;     // 同一槽位 (或空闲链表) 的下一个节点，节点号从1开始，0 表示结束
+    uint8_t prev;     // 同一槽位的上一个节点
+    uint8_t slot;     // 所在槽位 (层号 * WHEEL_SLOTS + 槽号)，SLOT_NONE 表示未启动
+    uint8_t used;     // 已分配
+} SoftTimer_Node_t;
+
+static SoftTimer_Node_t s_nodes[SOFT_TIMER_POOL_SIZE];
+static uint8_t  s_wheel[SOFT_TIMER_LEVELS * WHEEL_SLOTS]; // 每个槽位的链表头节点号
+static uint32_t s_occupied[SOFT_TIMER_LEVELS];            // 每层非空槽位位图
+static uint32_t s_next_tick;                              // 下一个待处理的 tick
+static uint8_t  s_free;                                   // 空闲链表头节点号
+
+static inline SoftTimer_Node_t *_node(uint8_t id)
+{
+    return &s_nodes[id - 1];
+}
+
+// 按到期时刻相对时间轮当前位置的距离选择层，再按到期时刻在该层的位选择槽位
+static void _link(uint8_t id)
+{
+    SoftTimer_Node_t *n = _node(id);
+    uint32_t when = n->expire;
+    uint32_t delta;
+    uint8_t level, slot, index;
+
+    if ((int32_t)(when - s_next_tick) < 0) {
+        when = s_next_tick; // 已过期，下一个 tick 处理
+    }
+    delta = when - s_next_tick;
+    if (delta >= WHEEL_SPAN) {
+        // 超出范围，先挂在最高层最远的槽位，下移时按真实到期时刻重新放置
+        delta = WHEEL_SPAN - 1;
+        when = s_next_tick + delta;
+    }
+    for (level = 0; level < SOFT_TIMER_LEVELS - 1 && delta >= (1uL << (WHEEL_BITS * (level + 1))); level++) {
+    }
+    slot = (uint8_t)((when >> (WHEEL_BITS * level)) & WHEEL_MASK);
+    index = (uint8_t)(level * WHEEL_SLOTS + slot);
+
+    n->slot = index;
+    n->prev = 0;
+    n->next = s_wheel[index];
+    if (n->next) {
+        _node(n->next)->prev = id;
+    }
+    s_wheel[index] = id;
+    s_occupied[level] |= 1uL << slot;
+}
+
+static void _unlink(uint8_t id)
+{
+    SoftTimer_Node_t *n = _node(id);
+    uint8_t index = n->slot;
+
+    if (n->prev) {
+        _node(n->prev)->next = n->next;
+    } else {
+        s_wheel[index] = n->next;
+        if (!n->next) {
+            s_occupied[index / WHEEL_SLOTS] &= ~(1uL << (index % WHEEL_SLOTS));
+        }
+    }
+    if (n->next) {
+        _node(n->next)->prev = n->prev;
+    }
+    n->slot = SLOT_NONE;
+}
+
+// 高层槽位整体取下，按剩余时间重新放入低层
+static void _cascade(uint8_t level, uint8_t slot)
+{
+    uint8_t index = (uint8_t)(level * WHEEL_SLOTS + slot);
+    uint8_t id = s_wheel[index];
+
+    s_wheel[index] = 0;
+    s_occupied[level] &= ~(1uL << slot);
+    while (id) {
+        uint8_t next = _node(id)->next;
+        _link(id);
+        id = next;
+    }
+}
+
+// 执行第 0 层一个槽位上的全部定时器
+static void _expire(uint8_t slot, uint32_t now)
+{
+    uint8_t id;
+
+    // 每次从链表头取一个，回调中启动/停止其他定时器也不会破坏遍历
+    while ((id = s_wheel[slot]) != 0) {
+        SoftTimer_Node_t *n = _node(id);
+
+        _unlink(id);
+        if (n->period) {
+            // 先重新挂上，回调中可以直接停止；落后一个周期以上 (补 tick) 时不补执行
+            n->expire += n->period;
+            if ((int32_t)(n->expire - now) <= 0) {
+                n->expire = now + n->period;
+            }
+            _link(id);
+        }
+        n->cb(n->arg);
+    }
+}
+
+void SoftTimer_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < SOFT_TIMER_LEVELS * WHEEL_SLOTS; i++) {
+        s_wheel[i] = 0;
+    }
+    for (i = 0; i < SOFT_TIMER_LEVELS; i++) {
+        s_occupied[i] = 0;
+    }
+    for (i = 0; i < SOFT_TIMER_POOL_SIZE; i++) {
+        s_nodes[i].used = 0;
+        s_nodes[i].slot = SLOT_NONE;
+        s_nodes[i].next = (uint8_t)(i + 2 <= SOFT_TIMER_POOL_SIZE ? i + 2 : 0);
+    }
+    s_free = SOFT_TIMER_POOL_SIZE ? 1 : 0;
+    s_next_tick = HAL_GetTick();
+}
+
+SoftTimer_t SoftTimer_Create(SoftTimer_Callback_t cb, void *arg)
+{
+    uint32_t primask = Critical_Enter();
+    uint8_t id = s_free;
+
+    if (id) {
+        SoftTimer_Node_t *n = _node(id);
+        s_free = n->next;
+        n->cb = cb;
+        n->arg = arg;
+        n->period = 0;
+        n->slot = SLOT_NONE;
+        n->used = 1;
+    }
+    Critical_Exit(primask);
+    return id;
+}
+
+void SoftTimer_Delete(SoftTimer_t t)
+{
+    SoftTimer_Node_t *n;
+    uint32_t primask;
+
+    if (!t) {
+        return;
+    }
+    n = _node(t);
+    primask = Critical_Enter();
+    if (n->slot != SLOT_NONE) {
+        _unlink(t);
+    }
+    n->used = 0;
+    n->next = s_free;
+    s_free = t;
+    Critical_Exit(primask);
+}
+
+void SoftTimer_Start(SoftTimer_t t, uint32_t delay_ms, uint16_t period_ms)
+{
+    SoftTimer_Node_t *n;
+    uint32_t primask;
+
+    if (!t) {
+        return;
+    }
+    n = _node(t);
+    primask = Critical_Enter();
+    if (n->slot != SLOT_NONE) {
+        _unlink(t);
+    }
+    n->expire = HAL_GetTick() + (delay_ms ? delay_ms : 1);
+    n->period = period_ms;
+    _link(t);
+    Critical_Exit(primask);
+}
+
+void SoftTimer_Stop(SoftTimer_t t)
+{
+    uint32_t primask;
+
+    if (!t) {
+        return;
+    }
+    primask = Critical_Enter();
+    if (_node(t)->slot != SLOT_NONE) {
+        _unlink(t);
+    }
+    Critical_Exit(primask);
+}
+
+uint8_t SoftTimer_IsActive(SoftTimer_t t)
+{
+    return t && _node(t)->slot != SLOT_NONE;
+}
+
+void SoftTimer_Tick(void)
+{
+    uint32_t now = HAL_GetTick();
+    PROF_ENTER(PROF_SOFT_TIMER);
+
+    while ((int32_t)(now - s_next_tick) >= 0) {
+        uint8_t slot = (uint8_t)(s_next_tick & WHEEL_MASK);
+
+        // 第 0 层转满一圈，从上一层取下对应槽位；上一层也转满一圈时继续向上
+        if (slot == 0) {
+            uint8_t level;
+            for (level = 1; level < SOFT_TIMER_LEVELS; level++) {
+                uint8_t index = (uint8_t)((s_next_tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+                if (s_occupied[level] & (1uL << index)) {
+                    _cascade(level, index);
+                }
+                if (index) {
+                    break;
+                }
+            }
+        }
+
+        // 本圈剩余槽位都为空时直接跳到下一圈起点 (补休眠期间的 tick)
+        if (!(s_occupied[0] & (0xFFFFFFFFuL << slot))) {
+            uint32_t lap = (s_next_tick | WHEEL_MASK) + 1;
+            if ((int32_t)(now - lap) < 0) {
+                s_next_tick = now + 1;
+                break;
+            }
+            s_next_tick = lap;
+            continue;
+        }
+
+        if (s_occupied[0] & (1uL << slot)) {
+            _expire(slot, now);
+        }
+        s_next_tick++;
+    }
+    PROF_EXIT(PROF_SOFT_TIMER);
+}
+
+uint32_t SoftTimer_NextDeadline(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t next = UINT32_MAX;
+    uint8_t i;
+
+    for (i = 0; i < SOFT_TIMER_POOL_SIZE; i++) {
+        const SoftTimer_Node_t *n = &s_nodes[i];
+        if (n->used && n->slot != SLOT_NONE) {
+            int32_t remain = (int32_t)(n->expire - now);
+            if (remain <= 0) {
+                return 0;
+            }
+            if ((uint32_t)remain < next) {
+                next = (uint32_t)remain;
+            }
+        }
+    }
+    return next;
+}
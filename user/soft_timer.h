@@ -0,0 +1,65 @@
+/* === C/C++ Header代码文件: soft_timer.h === */
+#ifndef __SOFT_TIMER_H
+#define __SOFT_TIMER_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 分层时间轮软件定时器
+//
+// 定时器节点来自静态节点池 (不使用堆)，按到期时刻挂在时间轮的槽位链表上:
+// 第 0 层每槽 1ms，第 k 层每槽 32^k ms，共 SOFT_TIMER_LEVELS 层。
+// 启动/停止/到期都是 O(1)；高层槽位只在低层转满一圈时整体下移一次。
+// 每个 tick 只检查当前槽位，工作量与本 tick 到期的定时器数成正比，与定时器总数无关；
+// 休眠后补 tick 时跳过整段空槽位，不逐毫秒空转。
+// 超过时间轮范围 (32^SOFT_TIMER_LEVELS ms) 的定时器先挂在最高层，下移时按剩余时间重新放置。
+//
+// SoftTimer_Tick 由 1ms 节拍 (调度器任务) 调用，回调在该中断上下文中执行，须简短；
+// 主循环中调用 Start/Stop 等接口时内部会短暂关中断。
+
+#ifndef SOFT_TIMER_POOL_SIZE
+#define SOFT_TIMER_POOL_SIZE   8     // 节点池大小 (同时存在的定时器数)
+#endif
+#ifndef SOFT_TIMER_LEVELS
+#define SOFT_TIMER_LEVELS      3     // 时间轮层数，默认范围 32768ms
+#endif
+
+// 定时器句柄，0 表示无效 (SoftTimer_Create 失败的返回值)，传给下列函数时不做任何操作
+typedef uint8_t SoftTimer_t;
+
+typedef void (*SoftTimer_Callback_t)(void *arg);
+
+// 以当前 HAL_GetTick 为时间轮起点，清空节点池
+void SoftTimer_Init(void);
+
+/**
+ * @brief 从节点池分配一个定时器 (未启动)
+ * @return 句柄，节点池已满返回0
+ */
+SoftTimer_t SoftTimer_Create(SoftTimer_Callback_t cb, void *arg);
+
+// 停止并把节点还给节点池
+void SoftTimer_Delete(SoftTimer_t t);
+
+/**
+ * @brief 启动 (或重新启动) 定时器
+ * @param delay_ms 距离第一次到期的毫秒数，0 按 1 处理
+ * @param period_ms 到期后的重复周期 (ms)，0 表示单次定时
+ */
+void SoftTimer_Start(SoftTimer_t t, uint32_t delay_ms, uint16_t period_ms);
+
+void SoftTimer_Stop(SoftTimer_t t);
+
+uint8_t SoftTimer_IsActive(SoftTimer_t t);
+
+// 在 1ms 节拍中调用，处理到当前 HAL_GetTick 为止所有到期的定时器
+void SoftTimer_Tick(void);
+
+/**
+ * @brief 距离最早一个定时器到期的毫秒数，用于无节拍空闲
+ * @return 0: 已有定时器到期; UINT32_MAX: 没有运行中的定时器
+ * @note  遍历节点池，只在空闲时调用
+ */
+uint32_t SoftTimer_NextDeadline(void);
+
+#endif
@@ -0,0 +1,74 @@
+/* === C代码文件: tickless.c === */
+#include "tickless.h"
+
+static TIM_HandleTypeDef *s_htim;
+static uint8_t s_drives_hal_tick;
+
+void Tickless_Init(TIM_HandleTypeDef *htim, uint8_t drives_hal_tick)
+{
+    s_htim = htim;
+    s_drives_hal_tick = drives_hal_tick;
+}
+
+uint32_t Tickless_Sleep(uint32_t ms)
+{
+    TIM_TypeDef *tim = s_htim->Instance;
+    uint32_t period = s_htim->Init.Period + 1; // 每毫秒的计数
+    uint32_t base, expired, q, slept;
+
+    // 计数器从最近一次更新事件起连续计数，base 为正在走的这一毫秒的序号 (此前的整毫秒都已计入 HAL tick)；
+    // 上次提前唤醒后这次更新事件还没到来时 base 可以大于0
+    base = tim->CNT / period;
+    if (ms > TICKLESS_MAX_MS) {
+        ms = TICKLESS_MAX_MS;
+    }
+    if (ms > 0x10000u / period - base) {
+        ms = 0x10000u / period - base;
+    }
+    if (!s_drives_hal_tick) {
+        HAL_SuspendTick();
+    }
+
+    // 节拍定时器不停、不改 PSC，只把当前周期的 ARR 拉长到之后第 ms 个节拍边界 (关 ARPE，立即生效)，
+    // 节拍相位在休眠前后保持不变
+    tim->CR1 &= ~TIM_CR1_ARPE;
+    tim->ARR = (base + ms) * period - 1;
+    if (tim->SR & TIM_SR_UIF) {
+        // 拉长之前节拍已经到来: 不休眠，下面把 ARR 改回，开中断后先执行这次节拍
+        expired = 0;
+        slept = 0;
+    } else {
+        __WFI(); // 定时到期、按键 EXTI 或其他中断唤醒
+
+        expired = (tim->SR & TIM_SR_UIF) != 0;
+        if (expired) {
+            slept = ms;
+        } else {
+            // 提前唤醒: ARR 改为正在走的这一毫秒的结束处，不足 1ms 的部分留给这次更新事件。
+            // 改写前计数器若已越过新的 ARR (会一直数到 65535) 就按新的计数值重写
+            do {
+                q = tim->CNT;
+                tim->ARR = (q / period + 1) * period - 1;
+            } while (tim->CNT > tim->ARR);
+            slept = q / period - base;
+        }
+    }
+
+    // 统一时基下到期的这次更新事件由节拍中断推进最后 1ms，提前唤醒时由这一毫秒结束的更新事件推进；
+    // 否则 HAL tick 由恢复后的 SysTick 计时，把整毫秒全部补上
+    uwTick += (s_drives_hal_tick && expired) ? slept - 1 : slept;
+
+    // 恢复节拍周期: 写入预装载，在下一次更新事件时生效；更新事件已经发生时计数器已从0开始数拉长的周期，
+    // 须立即改回
+    tim->CR1 |= TIM_CR1_ARPE;
+    tim->ARR = period - 1;
+    if (tim->SR & TIM_SR_UIF) {
+        tim->CR1 &= ~TIM_CR1_ARPE;
+        tim->ARR = period - 1;
+        tim->CR1 |= TIM_CR1_ARPE;
+    }
+    if (!s_drives_hal_tick) {
+        HAL_ResumeTick();
+    }
+    return slept;
+}
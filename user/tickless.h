@@ -0,0 +1,34 @@
+/* === C/C++ Header代码文件: tickless.h === */
+#ifndef __TICKLESS_H
+#define __TICKLESS_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 无节拍休眠
+//
+// 节拍定时器 (TIM17) 不停止，把当前周期的 ARR 拉长到之后第 N 个节拍边界后 WFI 休眠，定时到期或任一中断唤醒；
+// 提前唤醒时把 ARR 改回正在走的这一毫秒的结束处。醒来后把走完的整毫秒补到 HAL tick 上，之后按 1ms 节拍继续。
+// 计数器和预分频器始终不复位，节拍相位在休眠前后不变，提前唤醒不足 1ms 的部分由随后的节拍补上，
+// 多次休眠后 HAL tick 与真实时间的误差仍不超过 1ms。Stop 模式下 TIM17 不计数，因此只用 Sleep 模式。
+// 节拍定时器须开启 ARR 预装载 (CubeMX 中 AutoReloadPreload 为 ENABLE)。
+
+#ifndef TICKLESS_MAX_MS
+#define TICKLESS_MAX_MS   655u  // 单次休眠上限 (沿用节拍的 10us 计数，ARR 为16位)
+#endif
+
+/**
+ * @brief 绑定 1ms 节拍定时器
+ * @param htim 节拍定时器，恢复节拍时使用其 Init 中的 PSC/ARR
+ * @param drives_hal_tick 1: 节拍中断同时推进 HAL tick (统一时基); 0: HAL tick 由 SysTick 推进，休眠期间暂停 SysTick
+ */
+void Tickless_Init(TIM_HandleTypeDef *htim, uint8_t drives_hal_tick);
+
+/**
+ * @brief 休眠最多 ms 毫秒 (超过 TICKLESS_MAX_MS 按上限)，ms 应大于1
+ * @return 实际休眠的整毫秒数 (不含唤醒时正在走的这一毫秒)
+ * @note  须在关中断状态下调用 (计算休眠时长之前就关中断，期间的中断都能唤醒)，返回时仍为关中断
+ */
+uint32_t Tickless_Sleep(uint32_t ms);
+
+#endif
@@ -0,0 +1,75 @@
+/* === C代码文件: trace.c === */
+#include "trace.h"
+#include "critical.h"
+#include "uart_tx.h"
+
+#if TRACE_ENABLE
+
+_Static_assert(sizeof(Trace_Record_t) == 8, "trace records are 8 bytes");
+_Static_assert((TRACE_DEPTH & (TRACE_DEPTH - 1)) == 0, "TRACE_DEPTH must be a power of two");
+
+Trace_Buffer_t trace_buffer;
+static volatile uint8_t s_paused; // Trace_Dump 输出期间不记录，避免输出到一半的记录被覆盖
+
+void Trace_Init(void)
+{
+    uint32_t primask = Critical_Enter();
+
+    trace_buffer.magic = TRACE_MAGIC;
+    trace_buffer.head = 0;
+    trace_buffer.depth = TRACE_DEPTH;
+    trace_buffer.sub_per_ms = (uint16_t)(TIM17->ARR + 1);
+    s_paused = 0;
+    Critical_Exit(primask);
+}
+
+void Trace_Record(uint8_t id, uint16_t arg)
+{
+    uint32_t primask = Critical_Enter();
+    uint32_t tick = uwTick;
+    uint32_t sub = TIM17->CNT;
+
+    if (TIM17->CR1 & TIM_CR1_OPM) {
+        // 无节拍休眠中 (按键 EXTI 唤醒): TIM17 按 1kHz 单次计数，uwTick 醒来后才补上
+        tick += sub;
+        sub = 0;
+    } else if ((TIM17->SR & TIM_SR_UIF) && sub < (TIM17->ARR >> 1)) {
+        // 计数器已回绕但节拍中断还没来得及执行 (在更高优先级中断或临界区中)
+        tick++;
+    }
+    if (!s_paused) {
+        Trace_Record_t *r = &trace_buffer.rec[trace_buffer.head & (TRACE_DEPTH - 1)];
+        r->tick = tick;
+        r->sub = (uint8_t)sub;
+        r->id = id;
+        r->arg = arg;
+        trace_buffer.head++;
+    }
+    Critical_Exit(primask);
+}
+
+#define DUMP_LINE_BYTES  32 // 每行输出的字节数
+
+void Trace_Dump(void)
+{
+    static const char digits[] = "0123456789abcdef";
+    const uint8_t *p = (const uint8_t *)&trace_buffer;
+    char line[6 + DUMP_LINE_BYTES * 2 + 2] = "trace ";
+    uint16_t i = 0;
+
+    s_paused = 1;
+    while (i < sizeof(trace_buffer)) {
+        uint16_t n = 6;
+        do {
+            line[n++] = digits[p[i] >> 4];
+            line[n++] = digits[p[i] & 0x0Fu];
+        } while (++i < sizeof(trace_buffer) && i % DUMP_LINE_BYTES);
+        line[n++] = '\r';
+        line[n++] = '\n';
+        // 整个缓冲区比发送缓冲区长，等待 DMA 腾出空间，不丢弃
+        UartTx_Send(line, n, UART_TX_BLOCK);
+    }
+    s_paused = 0;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/* === C/C++ Header代码文件: trace.h === */
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// 事件追踪 (飞行记录仪)
+//
+// RAM 中一个固定长度的环形缓冲区，每条记录8字节: 毫秒 tick、tick 内的 TIM17 计数 (子节拍)、事件号和一个16位参数。
+// 记录时不做任何格式化，只在极短的临界区内占用一个槽位并写入两个字，中断和主循环都可以调用。
+// 缓冲区写满后覆盖最旧的记录，始终保留最近 TRACE_DEPTH 条。
+//
+// 取出方式:
+//   1. 调试器: (gdb) dump binary value trace.bin trace_buffer
+//   2. Trace_Dump: 经 USART1 TX 发送缓冲区 (uart_tx.h) 以 "trace <十六进制>" 文本行输出同样的字节
+// 用 tools/trace2perfetto.py 转换为 Chrome/Perfetto 的 trace JSON，在 ui.perfetto.dev 中查看时间线。
+//
+// TRACE_ENABLE 为0 (默认) 时 TRACE() 和所有接口都编译为空，不占用 RAM。
+// 在 CMake 中用 -DTRACE=ON 打开。
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE      0
+#endif
+#ifndef TRACE_DEPTH
+#define TRACE_DEPTH       32      // 记录条数，须为2的幂
+#endif
+
+#define TRACE_MAGIC       0x45435254u  // "TRCE"，转换工具据此识别缓冲区和字节序
+
+// 事件号，新增事件时同步修改 tools/trace2perfetto.py 中的名称表
+typedef enum {
+    TRACE_EXTI            = 0x01, // 按键 EXTI 中断，参数为 GPIO_Pin
+    TRACE_MONITOR         = 0x02, // MO 引脚 (PA8) 电平，参数为 0/1
+    TRACE_LED_START       = 0x03, // 启动 LED 效果，参数为 LED_Mode_t
+    TRACE_BUTTON_EVENT    = 0x10, // 按键状态机产生事件，事件号为 TRACE_BUTTON_EVENT + Button_Event_t，参数为引脚
+    TRACE_BUTTON_CALLBACK = 0x20, // 开始执行按键回调，事件号为 TRACE_BUTTON_CALLBACK + Button_Event_t，参数为引脚
+    TRACE_BUTTON_RETURN   = 0x2F, // 按键回调返回，参数为引脚
+} Trace_Id_t;
+
+typedef struct {
+    uint32_t tick;  // HAL_GetTick()
+    uint8_t sub;    // tick 内的 TIM17 计数 (0 ~ sub_per_ms - 1)
+    uint8_t id;     // Trace_Id_t
+    uint16_t arg;
+} Trace_Record_t;
+
+// 缓冲区布局即导出格式 (小端)，转换工具按此解析
+typedef struct {
+    uint32_t magic;       // TRACE_MAGIC
+    uint32_t head;        // 累计写入条数，下一条写入 rec[head % depth]
+    uint16_t depth;       // TRACE_DEPTH
+    uint16_t sub_per_ms;  // 每毫秒的子节拍数 (TIM17 ARR + 1)
+    Trace_Record_t rec[TRACE_DEPTH];
+} Trace_Buffer_t;
+
+#if TRACE_ENABLE
+
+extern Trace_Buffer_t trace_buffer;
+
+#define TRACE(id, arg)  Trace_Record((uint8_t)(id), (uint16_t)(arg))
+
+// 清空缓冲区，须在 MX_TIM17_Init 之后调用
+void Trace_Init(void);
+
+void Trace_Record(uint8_t id, uint16_t arg);
+
+// 从 USART1 输出整个缓冲区 (发送缓冲区满时等待，期间暂停记录)，应在主循环中调用
+void Trace_Dump(void);
+
+#else
+
+#define TRACE(id, arg)   ((void)0)
+#define Trace_Init()     ((void)0)
+#define Trace_Dump()     ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,210 @@
+/* === C代码文件: uart_tx.c === */
+#include "uart_tx.h"
+#include "critical.h"
+#include "kernel.h"
+#include "mempool.h"
+#include <string.h>
+
+#define UART_TX_MASK  (UART_TX_BUF_SIZE - 1u)
+
+_Static_assert((UART_TX_BUF_SIZE & UART_TX_MASK) == 0 && UART_TX_BUF_SIZE <= 32768u,
+               "UART_TX_BUF_SIZE must be a power of two that fits the uint16_t counters");
+_Static_assert(UART_TX_BUF_SIZE <= MEMPOOL_LARGE_SIZE, "the ring buffer is taken from the large memory pool");
+
+// 计数器自由增长，取下标时与掩码相与:
+// [s_dma, s_tail) 正在 DMA 发送 (DMA 空闲时为空)，[s_tail, s_head) 等待发送，
+// 占用空间从 s_dma 算起，正在发送的一段在传输完成前不会被覆盖。
+// 缓冲区在第一次初始化时从内存池的大块等级申请，申请失败时所有写入都按丢弃计数
+static uint8_t *s_buf;
+static volatile uint16_t s_head;
+static volatile uint16_t s_tail;
+static volatile uint16_t s_dma;
+static UartTx_Policy_t s_policy;
+static UartTx_Stats_t s_stats;
+
+// 把 [s_tail, s_head) 中到缓冲区末尾为止的一段交给 DMA，调用时 DMA 必须空闲
+static void _start(void)
+{
+    uint16_t pos = s_tail & UART_TX_MASK;
+    uint16_t n = (uint16_t)(s_head - s_tail);
+
+    if (!n) {
+        return;
+    }
+    if (n > UART_TX_BUF_SIZE - pos) {
+        n = (uint16_t)(UART_TX_BUF_SIZE - pos);
+    }
+    // USART1_TX 对应 DMA1 通道2: 存储器 -> USART1->TDR，8位，传输完成中断
+    DMA1_Channel2->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE;
+    DMA1_Channel2->CMAR = (uint32_t)&s_buf[pos];
+    DMA1_Channel2->CNDTR = n;
+    s_dma = s_tail;
+    s_tail = (uint16_t)(s_tail + n);
+    DMA1_Channel2->CCR |= DMA_CCR_EN;
+}
+
+// 只有主循环可以等待 DMA: 中断和内核任务中等待会推迟节拍处理，关中断时 DMA 中断也进不来
+static uint8_t _can_wait(void)
+{
+    return __get_IPSR() == 0 && __get_PRIMASK() == 0 && Kernel_CurrentPriority() == 0;
+}
+
+void UartTx_Init(void)
+{
+    if (!s_buf) {
+        s_buf = (uint8_t *)Mem_Alloc(UART_TX_BUF_SIZE);
+    }
+    s_head = 0;
+    s_tail = 0;
+    s_dma = 0;
+    s_policy = UART_TX_POLICY;
+    s_stats.written = 0;
+    s_stats.dropped = 0;
+    s_stats.peak = 0;
+
+    // USART1: 8N1，只开发送，发送数据由 DMA 写入
+    __HAL_RCC_USART1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    USART1->CR1 = 0;
+    USART1->BRR = (HAL_RCC_GetPCLK1Freq() + UART_TX_BAUDRATE / 2) / UART_TX_BAUDRATE;
+    USART1->CR3 = USART_CR3_DMAT;
+    USART1->CR1 = USART_CR1_TE | USART_CR1_UE;
+
+    DMA1_Channel2->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    DMA1_Channel2->CPAR = (uint32_t)&USART1->TDR;
+
+    // 与 WS2812 (通道3) 共用一个中断向量，优先级保持一致
+    HAL_NVIC_SetPriority(DMA1_Channel2_3_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_3_IRQn);
+}
+
+void UartTx_SetPolicy(UartTx_Policy_t policy)
+{
+    s_policy = policy;
+}
+
+uint16_t UartTx_Send(const void *data, uint16_t len, UartTx_Policy_t policy)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    uint16_t accepted = 0;
+
+    if (!s_buf) {
+        s_stats.dropped += len;
+        return 0;
+    }
+    if (policy == UART_TX_BLOCK && !_can_wait()) {
+        policy = UART_TX_DROP;
+    }
+
+    while (len) {
+        uint16_t n = len < UART_TX_CHUNK ? len : UART_TX_CHUNK;
+        uint32_t primask = Critical_Enter();
+        uint16_t used = (uint16_t)(s_head - s_dma);
+        uint16_t space = (uint16_t)(UART_TX_BUF_SIZE - used);
+        uint16_t pos, first;
+
+        if (space < n) {
+            if (policy == UART_TX_BLOCK) {
+                if (!space) {
+                    // 开中断等 DMA 发完当前一段
+                    Critical_Exit(primask);
+                    continue;
+                }
+                n = space;
+            } else if (policy == UART_TX_OVERWRITE) {
+                // 丢弃全部待发送的旧数据，新数据紧接在正在发送的一段之后写入;
+                // 正在发送的一段不能动，剩余数据仍放不下时跳过其开头，保留最新的
+                uint16_t pending = (uint16_t)(s_head - s_tail);
+                s_head = s_tail;
+                s_stats.dropped += pending;
+                space = (uint16_t)(space + pending);
+                if (len > space) {
+                    s_stats.dropped += (uint16_t)(len - space);
+                    src += len - space;
+                    len = space;
+                    if (n > len) {
+                        n = len;
+                    }
+                }
+            } else {
+                // 丢弃放不下的部分，剩余的数据也不再尝试
+                s_stats.dropped += (uint16_t)(len - space);
+                len = space;
+                n = space;
+            }
+        }
+
+        pos = s_head & UART_TX_MASK;
+        first = (uint16_t)(UART_TX_BUF_SIZE - pos);
+        if (first > n) {
+            first = n;
+        }
+        memcpy(&s_buf[pos], src, first);
+        memcpy(s_buf, src + first, (size_t)(n - first));
+        s_head = (uint16_t)(s_head + n);
+        s_stats.written += n;
+        used = (uint16_t)(s_head - s_dma);
+        if (used > s_stats.peak) {
+            s_stats.peak = used;
+        }
+        if (s_dma == s_tail) {
+            _start();
+        }
+        Critical_Exit(primask);
+
+        src += n;
+        len = (uint16_t)(len - n);
+        accepted = (uint16_t)(accepted + n);
+    }
+    return accepted;
+}
+
+uint16_t UartTx_Write(const void *data, uint16_t len)
+{
+    return UartTx_Send(data, len, s_policy);
+}
+
+void UartTx_Flush(void)
+{
+    if (!_can_wait()) {
+        return;
+    }
+    while (s_head != s_dma) {
+    }
+    while (!(USART1->ISR & USART_ISR_TC)) {
+    }
+}
+
+const UartTx_Stats_t *UartTx_Stats(void)
+{
+    return &s_stats;
+}
+
+void UartTx_DMA_IRQHandler(void)
+{
+    if (!(DMA1->ISR & DMA_ISR_TCIF2)) {
+        return;
+    }
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    DMA1_Channel2->CCR = 0;
+    s_dma = s_tail;
+    _start();
+}
+
+// 覆盖 syscalls.c 中的弱定义: printf/write 的输出复制到发送缓冲区后立即返回。
+// 按当前溢出策略丢弃的字节也算作已写入，避免 newlib 反复重试变成阻塞。
+// NO_MALLOC 下 printf 内部的内存分配由 mempool.c 的 __wrap__*_r 提供 (stdout 无缓冲，每次输出都到这里)
+int _write(int file, char *ptr, int len)
+{
+    int left = len;
+
+    (void)file;
+    while (left > 0) {
+        uint16_t n = left > 0x7FFF ? 0x7FFF : (uint16_t)left;
+        UartTx_Write(ptr, n);
+        ptr += n;
+        left -= n;
+    }
+    return len;
+}
@@ -0,0 +1,69 @@
+/* === C/C++ Header代码文件: uart_tx.h === */
+#ifndef __UART_TX_H
+#define __UART_TX_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// USART1 TX (PB6) 非阻塞发送
+//
+// 写入只是把数据复制到环形缓冲区，由 DMA1 通道2 在后台发送:
+// 每次发送缓冲区中一段连续的数据 (到缓冲区末尾为止)，发完在中断里接着发下一段。
+// _write (printf/write 的底层) 也走这里，调用者不再按字符等待 TXE。
+//
+// 缓冲区放不下时按溢出策略处理，丢弃的字节计入统计:
+//   UART_TX_DROP      丢弃新数据中放不下的部分
+//   UART_TX_OVERWRITE 丢弃所有尚未交给 DMA 的旧数据，保留最新的 (正在 DMA 发送的一段除外)
+//   UART_TX_BLOCK     等待 DMA 腾出空间; 在中断、临界区或内核任务中调用时按 UART_TX_DROP 处理，
+//                     不会卡住节拍
+// 复制按 UART_TX_CHUNK 字节分段进入临界区，中断和主循环可以同时写入 (不同来源的数据可能在分段处交错)。
+
+#ifndef UART_TX_BUF_SIZE
+#define UART_TX_BUF_SIZE   256     // 环形缓冲区大小，须为2的幂且不超过 MEMPOOL_LARGE_SIZE (从内存池申请)
+#endif
+#ifndef UART_TX_CHUNK
+#define UART_TX_CHUNK      32      // 每次临界区内最多复制的字节数
+#endif
+#ifndef UART_TX_BAUDRATE
+#define UART_TX_BAUDRATE   115200
+#endif
+#ifndef UART_TX_POLICY
+#define UART_TX_POLICY     UART_TX_DROP  // 默认溢出策略
+#endif
+
+typedef enum {
+    UART_TX_DROP,
+    UART_TX_OVERWRITE,
+    UART_TX_BLOCK
+} UartTx_Policy_t;
+
+typedef struct {
+    uint32_t written;  // 进入缓冲区的字节数
+    uint32_t dropped;  // 因缓冲区满丢弃的字节数
+    uint16_t peak;     // 缓冲区占用峰值
+} UartTx_Stats_t;
+
+// 配置 USART1 (8N1，只开发送) 和 DMA1 通道2，PB6 已由 MX_GPIO_Init 配置为 USART1_TX
+void UartTx_Init(void);
+
+// 设置 UartTx_Write 和 _write 使用的溢出策略
+void UartTx_SetPolicy(UartTx_Policy_t policy);
+
+/**
+ * @brief 按指定的溢出策略写入
+ * @return 进入缓冲区的字节数
+ */
+uint16_t UartTx_Send(const void *data, uint16_t len, UartTx_Policy_t policy);
+
+// 按当前溢出策略写入，返回进入缓冲区的字节数
+uint16_t UartTx_Write(const void *data, uint16_t len);
+
+// 等待缓冲区中的数据全部交给 USART (只能在主循环中调用)
+void UartTx_Flush(void);
+
+const UartTx_Stats_t *UartTx_Stats(void);
+
+// DMA1 通道2 中断处理，在 DMA1_Channel2_3_IRQHandler 中调用
+void UartTx_DMA_IRQHandler(void);
+
+#endif
@@ -0,0 +1,198 @@
+/* === C代码文件: ws2812.c === */
+#include "ws2812.h"
+#include "critical.h"
+
+#define WS2812_CHUNK_BYTES   (WS2812_CHUNK_PIXELS * WS2812_BYTES_PER_PIXEL)
+#define WS2812_HALF_BYTES    (WS2812_CHUNK_BYTES * WS2812_SPI_BYTES_PER_BYTE)
+
+// 4 个数据位 -> 16 个 SPI 位，高位先发 (0 -> 1000, 1 -> 1100)
+static const uint16_t s_nibble_code[16] = {
+    0x8888, 0x888C, 0x88C8, 0x88CC, 0x8C88, 0x8C8C, 0x8CC8, 0x8CCC,
+    0xC888, 0xC88C, 0xC8C8, 0xC8CC, 0xCC88, 0xCC8C, 0xCCC8, 0xCCCC
+};
+
+static uint8_t s_pixels[WS2812_MAX_PIXELS * WS2812_BYTES_PER_PIXEL]; // 工作缓冲区 (GRB)
+static uint8_t s_tx[WS2812_MAX_PIXELS * WS2812_BYTES_PER_PIXEL];     // 发送缓冲区 (GRB)
+static uint8_t s_dma_buf[2][WS2812_HALF_BYTES];                      // DMA 循环缓冲区的两半
+
+static uint16_t s_len;          // 一帧的颜色字节数
+static uint16_t s_pos;          // 下一个待编码的颜色字节
+static uint16_t s_halves_left;  // 本帧还要发完的半缓冲区数 (含复位段)
+static volatile uint8_t s_busy;
+static volatile uint8_t s_pending;
+
+// R/G/B 通道在 GRB 存储中的偏移
+static const uint8_t s_grb_offset[3] = { 1, 0, 2 };
+
+void WS2812_Encode(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+    while (len--) {
+        uint16_t hi = s_nibble_code[*src >> 4];
+        uint16_t lo = s_nibble_code[*src & 0x0F];
+        src++;
+        dst[0] = (uint8_t)(hi >> 8);
+        dst[1] = (uint8_t)hi;
+        dst[2] = (uint8_t)(lo >> 8);
+        dst[3] = (uint8_t)lo;
+        dst += WS2812_SPI_BYTES_PER_BYTE;
+    }
+}
+
+// 编码下一段像素到半缓冲区，像素发完后填低电平 (复位信号)
+static void _fill_half(uint8_t *out)
+{
+    uint16_t n = s_pos < s_len ? s_len - s_pos : 0;
+    uint16_t i;
+
+    if (n > WS2812_CHUNK_BYTES) {
+        n = WS2812_CHUNK_BYTES;
+    }
+    WS2812_Encode(&s_tx[s_pos], n, out);
+    s_pos += n;
+    for (i = n * WS2812_SPI_BYTES_PER_BYTE; i < WS2812_HALF_BYTES; i++) {
+        out[i] = 0;
+    }
+}
+
+// 锁定最新像素数据并启动一帧发送，调用时 DMA 必须空闲
+static void _start(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < s_len; i++) {
+        s_tx[i] = s_pixels[i];
+    }
+    s_pos = 0;
+    s_halves_left = (s_len + WS2812_CHUNK_BYTES - 1) / WS2812_CHUNK_BYTES + WS2812_RESET_CHUNKS;
+    _fill_half(s_dma_buf[0]);
+    _fill_half(s_dma_buf[1]);
+
+    // SPI1_TX 对应 DMA1 通道3: 存储器 -> SPI1->DR，8位，循环模式，半传输/传输完成中断
+    DMA1_Channel3->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF3;
+    DMA1_Channel3->CPAR = (uint32_t)&SPI1->DR;
+    DMA1_Channel3->CMAR = (uint32_t)&s_dma_buf[0][0];
+    DMA1_Channel3->CNDTR = sizeof(s_dma_buf);
+    DMA1_Channel3->CCR = DMA_CCR_PL_1 | DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_DIR |
+                         DMA_CCR_HTIE | DMA_CCR_TCIE;
+    s_busy = 1;
+    DMA1_Channel3->CCR |= DMA_CCR_EN;
+}
+
+uint8_t WS2812_Init(uint16_t pixels)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    uint16_t i;
+
+    if (pixels > WS2812_MAX_PIXELS) {
+        return 0;
+    }
+    s_len = pixels * WS2812_BYTES_PER_PIXEL;
+    for (i = 0; i < s_len; i++) {
+        s_pixels[i] = 0;
+    }
+    s_busy = 0;
+    s_pending = 0;
+
+    // PA7: SPI1_MOSI (AF0)
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    GPIO_InitStruct.Pin = GPIO_PIN_7;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF0_SPI1;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    // SPI1: 主机，只发送，8位，PCLK/16 = 3MHz，软件 NSS
+    __HAL_RCC_SPI1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    SPI1->CR1 = 0;
+    SPI1->CR1 = SPI_CR1_MSTR | SPI_CR1_BR_0 | SPI_CR1_BR_1 | SPI_CR1_SSM | SPI_CR1_SSI;
+    SPI1->CR2 = (7u << SPI_CR2_DS_Pos) | SPI_CR2_TXDMAEN;
+    SPI1->CR1 |= SPI_CR1_SPE;
+
+    HAL_NVIC_SetPriority(DMA1_Channel2_3_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_3_IRQn);
+
+    // 上电后先发一帧全灭
+    WS2812_Show();
+    return 1;
+}
+
+void WS2812_SetPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint8_t *p;
+
+    if (index >= s_len / WS2812_BYTES_PER_PIXEL) {
+        return;
+    }
+    p = &s_pixels[index * WS2812_BYTES_PER_PIXEL];
+    p[0] = g;
+    p[1] = r;
+    p[2] = b;
+}
+
+void WS2812_SetChannel(uint16_t channel, uint8_t value)
+{
+    uint16_t pixel = channel / WS2812_BYTES_PER_PIXEL;
+    uint16_t offset = pixel * WS2812_BYTES_PER_PIXEL + s_grb_offset[channel - pixel * WS2812_BYTES_PER_PIXEL];
+
+    if (offset < s_len) {
+        s_pixels[offset] = value;
+    }
+}
+
+uint8_t WS2812_GetChannel(uint16_t channel)
+{
+    uint16_t pixel = channel / WS2812_BYTES_PER_PIXEL;
+    uint16_t offset = pixel * WS2812_BYTES_PER_PIXEL + s_grb_offset[channel - pixel * WS2812_BYTES_PER_PIXEL];
+
+    return offset < s_len ? s_pixels[offset] : 0;
+}
+
+void WS2812_Show(void)
+{
+    uint32_t primask = Critical_Enter();
+    if (s_busy) {
+        s_pending = 1;
+    } else {
+        _start();
+    }
+    Critical_Exit(primask);
+}
+
+uint8_t WS2812_IsBusy(void)
+{
+    return s_busy;
+}
+
+void WS2812_DMA_IRQHandler(void)
+{
+    uint32_t isr = DMA1->ISR;
+    uint8_t *done;
+
+    // 只清除本次处理的标志: 中断被耽搁、两个标志都已置位时，另一半留给下一次进入中断处理
+    if (isr & DMA_ISR_HTIF3) {
+        DMA1->IFCR = DMA_IFCR_CHTIF3;
+        done = s_dma_buf[0];
+    } else if (isr & DMA_ISR_TCIF3) {
+        DMA1->IFCR = DMA_IFCR_CTCIF3;
+        done = s_dma_buf[1];
+    } else {
+        return;
+    }
+
+    // 最后一段复位信号已发完 (DMA 此时已开始重发另一半，其内容也是低电平)
+    if (--s_halves_left == 0) {
+        DMA1_Channel3->CCR &= ~DMA_CCR_EN;
+        s_busy = 0;
+        if (s_pending) {
+            s_pending = 0;
+            _start();
+        }
+        return;
+    }
+
+    // 刚发完的一半填入下一段，另一半正在发送
+    _fill_half(done);
+}
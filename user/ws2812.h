@@ -0,0 +1,65 @@
+/* === C/C++ Header代码文件: ws2812.h === */
+#ifndef __WS2812_H
+#define __WS2812_H
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+
+// WS2812 系列可寻址灯带输出，SPI1 MOSI (PA7) 产生单线时序
+//
+// SPI 时钟 = PCLK / 16 = 3MHz，每个 WS2812 数据位编码为 4 个 SPI 位 (1.33us):
+//   0 -> 1000 (高 0.33us)    1 -> 1100 (高 0.67us)
+// 编码按半字节查表，一个颜色字节查两次表得到 4 个 SPI 字节，CPU 不逐位操作。
+// DMA1 通道3 循环发送一个分为两半的小缓冲区，每发完一半在中断里编码下一段像素，
+// 全部像素发送后补发若干段低电平作为复位 (锁存) 信号。
+// 像素数据双缓冲: 写入的是工作缓冲区，WS2812_Show 把它复制到发送缓冲区再发送，
+// 发送期间可以继续渲染下一帧。
+
+#ifndef WS2812_MAX_PIXELS
+#define WS2812_MAX_PIXELS     16
+#endif
+#ifndef WS2812_CHUNK_PIXELS
+#define WS2812_CHUNK_PIXELS   4     // DMA 半缓冲区容纳的像素数 (发送时间 4*32us = 128us)
+#endif
+#ifndef WS2812_RESET_CHUNKS
+#define WS2812_RESET_CHUNKS   3     // 复位低电平段数，3*128us 满足新版 WS2812B 的 280us 要求
+#endif
+
+#define WS2812_BYTES_PER_PIXEL   3   // GRB
+#define WS2812_SPI_BYTES_PER_BYTE 4  // 每个颜色字节编码后的 SPI 字节数
+
+/**
+ * @brief 把颜色字节编码为 SPI 位流 (纯查表，不依赖硬件)
+ * @param src 颜色字节 (GRB 顺序)
+ * @param len 字节数
+ * @param dst 输出缓冲区，长度为 len * WS2812_SPI_BYTES_PER_BYTE
+ */
+void WS2812_Encode(const uint8_t *src, uint16_t len, uint8_t *dst);
+
+/**
+ * @brief 配置 PA7 (SPI1_MOSI)、SPI1 和 DMA1 通道3，所有像素清零
+ * @param pixels 灯珠数量
+ * @return 1: 成功; 0: 超出 WS2812_MAX_PIXELS
+ */
+uint8_t WS2812_Init(uint16_t pixels);
+
+void WS2812_SetPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b);
+
+// 按颜色通道读写，channel = 像素序号 * 3 + (0:R, 1:G, 2:B)
+void WS2812_SetChannel(uint16_t channel, uint8_t value);
+uint8_t WS2812_GetChannel(uint16_t channel);
+
+/**
+ * @brief 发送当前工作缓冲区
+ * @note  空闲时立即开始发送；正在发送时记下请求，本帧 (含复位信号) 结束后在中断里接着发送最新数据
+ */
+void WS2812_Show(void);
+
+uint8_t WS2812_IsBusy(void);
+
+/**
+ * @brief DMA1 通道2/3 中断处理，在 DMA1_Channel2_3_IRQHandler 中调用
+ */
+void WS2812_DMA_IRQHandler(void);
+
+#endif